@@ -30,6 +30,351 @@
 #include <string.h>
 #include <assert.h>
 
+// Pointer access. On a single core (thread vs. interrupt) plain accesses are enough, with producer and consumer on
+// different cores the pointer snapshot must be acquired and the pointer that publishes data or space released.
+#if CIRCULARBUFFER_SMP && CIRCULARBUFFER_TSAN
+// ThreadSanitizer does not support fences, the instrumented build targets strongly ordered hosts.
+#define CircularBuffer_loadPointers(bufferObject) CircularBuffer_loadPointersSplit(bufferObject)
+#define CircularBuffer_storePointer(pointer, value) __atomic_store_n(&(pointer), (uint16_t)(value), __ATOMIC_RELEASE)
+#define CircularBuffer_orderLoads() __atomic_signal_fence(__ATOMIC_ACQUIRE)
+#elif CIRCULARBUFFER_SMP
+#define CircularBuffer_loadPointers(bufferObject) __atomic_load_n((const uint32_t *)(bufferObject), __ATOMIC_ACQUIRE)
+#define CircularBuffer_storePointer(pointer, value) __atomic_store_n(&(pointer), (uint16_t)(value), __ATOMIC_RELEASE)
+#define CircularBuffer_orderLoads() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#define CircularBuffer_loadPointers(bufferObject) (*((const uint32_t *)(bufferObject)))
+#define CircularBuffer_storePointer(pointer, value) ((pointer) = (value))
+#define CircularBuffer_orderLoads() __atomic_signal_fence(__ATOMIC_ACQUIRE)
+#endif
+
+#if CIRCULARBUFFER_SMP && CIRCULARBUFFER_TSAN
+/*
+ * @brief Loads the pointers one by one. ThreadSanitizer does not pair a 32-bit load with the 16-bit stores of the
+ *        pointers and would report every handoff as a race. The pointer of the calling side does not change meanwhile,
+ *        so the pair is consistent for the producer and the consumer.
+ * @param bufferObject The buffer object handler.
+ * @return The pointers in the layout of CircularBufferPointers_t.
+ */
+static inline uint32_t CircularBuffer_loadPointersSplit(const CircularBufferObject_t * const bufferObject) {
+	CircularBufferPointers_t pointers;
+	uint32_t value;
+	pointers.front = __atomic_load_n(&bufferObject->front, __ATOMIC_ACQUIRE);
+	pointers.back = __atomic_load_n(&bufferObject->back, __ATOMIC_ACQUIRE);
+	memcpy(&value, &pointers, sizeof(value));
+	return value;
+}
+#endif
+
+/*
+ * @brief Loads a snapshot of both pointers. The loaded word is copied into the struct rather than stored through a cast
+ *        pointer, which would break strict aliasing. The copy compiles to a register move.
+ * @param bufferObject The buffer object handler.
+ * @return The pointers.
+ */
+static inline CircularBufferPointers_t CircularBuffer_loadSnapshot(const CircularBufferObject_t * const bufferObject) {
+	CircularBufferPointers_t pointers;
+	const uint32_t value = CircularBuffer_loadPointers(bufferObject);
+	memcpy(&pointers, &value, sizeof(pointers));
+	return pointers;
+}
+
+/*
+ * @brief Wraps a pointer that was advanced by at most the length, by mask for power of 2 lengths and by conditional
+ *        subtract instead of modulo otherwise.
+ * @param bufferObject The buffer object handler.
+ * @param pointer The advanced pointer.
+ * @return The pointer within the buffer memory.
+ */
+static inline uint16_t CircularBuffer_wrap(const CircularBufferObject_t * const bufferObject, const uint32_t pointer) {
+#if CIRCULARBUFFER_ANYLENGTH
+	if (!bufferObject->lengthMask) {
+		return (uint16_t)((pointer >= bufferObject->length) ? (pointer - bufferObject->length) : pointer);
+	}
+#endif
+	return (uint16_t)(pointer & bufferObject->lengthMask);
+}
+
+/*
+ * @brief Advances a pointer by one byte.
+ * @param bufferObject The buffer object handler.
+ * @param pointer The pointer.
+ * @return The next pointer within the buffer memory.
+ */
+static inline uint16_t CircularBuffer_next(const CircularBufferObject_t * const bufferObject, const uint16_t pointer) {
+#if CIRCULARBUFFER_ANYLENGTH
+	if (!bufferObject->lengthMask) {
+		return ((uint32_t)pointer + 1 == bufferObject->length) ? 0 : (uint16_t)(pointer + 1);
+	}
+#endif
+	return (uint16_t)((pointer + 1) & bufferObject->lengthMask);
+}
+
+/*
+ * @brief Gets the number of bytes from one pointer to another in the buffer.
+ * @param bufferObject The buffer object handler.
+ * @param from The start pointer.
+ * @param to The end pointer.
+ * @return The distance in bytes.
+ */
+static inline uint16_t CircularBuffer_distance(const CircularBufferObject_t * const bufferObject, const uint16_t from, const uint16_t to) {
+#if CIRCULARBUFFER_ANYLENGTH
+	if (!bufferObject->lengthMask) {
+		// Branch-free, adds the length only if the distance wraps.
+		return (uint16_t)(((uint32_t)to - from) + (bufferObject->length & (0UL - (uint32_t)(to < from))));
+	}
+#endif
+	return (uint16_t)((to - from) & bufferObject->lengthMask);
+}
+
+/*
+ * @brief Copies data into the buffer memory at a position, in 1 or 2 parts [OOoooOOO] -> [oooooOOO] + [OOoooooo].
+ * @param bufferObject The buffer object handler.
+ * @param position The write position.
+ * @param data Pointer to the data source.
+ * @param len Size of the data, at most the free size.
+ * @return The position after the copied data.
+ */
+static inline uint16_t CircularBuffer_copyIn(CircularBufferObject_t * const bufferObject, const uint16_t position, const uint8_t * const data, const uint16_t len) {
+	// Limit the first part by the end of the buffer.
+	uint16_t partialLen = len;
+	if ((bufferObject->length - position) < partialLen) {
+		partialLen = bufferObject->length - position;
+	}
+
+	// Copy actual bytes, the rest goes to the start of the buffer.
+	CircularBuffer_copy(&bufferObject->memory[position], data, partialLen);
+	if (partialLen < len) {
+		CircularBuffer_copy(bufferObject->memory, data + partialLen, len - partialLen);
+	}
+	return CircularBuffer_wrap(bufferObject, (uint32_t)position + len);
+}
+
+/*
+ * @brief Copies data out of the buffer memory from a position, in 1 or 2 parts.
+ * @param bufferObject The buffer object handler.
+ * @param position The read position.
+ * @param data Pointer to the output memory.
+ * @param len Size of the data, at most the unread size.
+ * @return The position after the copied data.
+ */
+static inline uint16_t CircularBuffer_copyOut(const CircularBufferObject_t * const bufferObject, const uint16_t position, uint8_t * const data, const uint16_t len) {
+	// Limit the first part by the end of the buffer.
+	uint16_t partialLen = len;
+	if ((bufferObject->length - position) < partialLen) {
+		partialLen = bufferObject->length - position;
+	}
+
+	// Copy actual bytes, the rest comes from the start of the buffer.
+	CircularBuffer_copy(data, &bufferObject->memory[position], partialLen);
+	if (partialLen < len) {
+		CircularBuffer_copy(data + partialLen, bufferObject->memory, len - partialLen);
+	}
+	return CircularBuffer_wrap(bufferObject, (uint32_t)position + len);
+}
+
+// Statistics. Each counter is updated by one side only, producer or consumer, so no locking is needed. Atomic on
+// multiple cores, so a reader on another core sees every counter whole.
+#if CIRCULARBUFFER_STATISTICS
+#if CIRCULARBUFFER_SMP || CIRCULARBUFFER_TSAN
+#define CircularBuffer_loadCounter(bufferObject, counter) __atomic_load_n(&(bufferObject)->statistics.counter, __ATOMIC_RELAXED)
+#define CircularBuffer_storeCounter(bufferObject, counter, value) __atomic_store_n(&(bufferObject)->statistics.counter, (value), __ATOMIC_RELAXED)
+#else
+#define CircularBuffer_loadCounter(bufferObject, counter) ((bufferObject)->statistics.counter)
+#define CircularBuffer_storeCounter(bufferObject, counter, value) ((bufferObject)->statistics.counter = (value))
+#endif
+#define CircularBuffer_count(bufferObject, counter, value) \
+	CircularBuffer_storeCounter(bufferObject, counter, CircularBuffer_loadCounter(bufferObject, counter) + (value))
+#define CircularBuffer_countUnread(bufferObject, unread) do { \
+		const uint16_t countedUnread = (unread); \
+		if (countedUnread > CircularBuffer_loadCounter(bufferObject, maxUnread)) { \
+			CircularBuffer_storeCounter(bufferObject, maxUnread, countedUnread); \
+		} \
+	} while (0)
+#else
+#define CircularBuffer_count(bufferObject, counter, value) ((void)0)
+#define CircularBuffer_countUnread(bufferObject, unread) ((void)0)
+#endif
+
+// Static tracepoints, compiled to a nop per probe. Enabled where <sys/sdt.h> exists unless set to 0. A tracer counts
+// up the semaphore of a probe while attached, probes with arguments that cost extra reads are skipped without it.
+#ifndef CIRCULARBUFFER_TRACEPOINTS
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define CIRCULARBUFFER_TRACEPOINTS 1
+#endif
+#endif
+#endif
+#ifndef CIRCULARBUFFER_TRACEPOINTS
+#define CIRCULARBUFFER_TRACEPOINTS 0
+#endif
+#if CIRCULARBUFFER_TRACEPOINTS
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#define CircularBuffer_semaphore(name) unsigned short circularbuffer_##name##_semaphore __attribute__((used, section(".probes")))
+CircularBuffer_semaphore(push_entry);
+CircularBuffer_semaphore(push_return);
+CircularBuffer_semaphore(pop_entry);
+CircularBuffer_semaphore(pop_return);
+CircularBuffer_semaphore(full);
+CircularBuffer_semaphore(fault_set);
+CircularBuffer_semaphore(fault_clear);
+#define CircularBuffer_probeActive(name) __builtin_expect(*(volatile unsigned short *)&circularbuffer_##name##_semaphore, 0)
+#define CircularBuffer_probe1(name, bufferObject) DTRACE_PROBE1(circularbuffer, name, bufferObject)
+#define CircularBuffer_probe3(name, bufferObject, a, b) DTRACE_PROBE3(circularbuffer, name, bufferObject, a, b)
+#else
+#define CircularBuffer_probeActive(name) 0
+#define CircularBuffer_probe1(name, bufferObject) ((void)0)
+#define CircularBuffer_probe3(name, bufferObject, a, b) ((void)0)
+#endif
+
+// Dwell tracing.
+#if CIRCULARBUFFER_DWELLTRACE
+#if (CIRCULARBUFFER_DWELLTRACE_MARKS & (CIRCULARBUFFER_DWELLTRACE_MARKS - 1)) || (CIRCULARBUFFER_DWELLTRACE_MARKS > 128)
+#error "CIRCULARBUFFER_DWELLTRACE_MARKS must be a power of 2 up to 128"
+#endif
+
+// Mark indexes, the producer publishes head after writing the mark and the consumer releases tail after reading it.
+#if CIRCULARBUFFER_SMP || CIRCULARBUFFER_TSAN
+#define CircularBuffer_loadMark(mark) __atomic_load_n(&(mark), __ATOMIC_ACQUIRE)
+#define CircularBuffer_storeMark(mark, value) __atomic_store_n(&(mark), (uint8_t)(value), __ATOMIC_RELEASE)
+#else
+#define CircularBuffer_loadMark(mark) (mark)
+#define CircularBuffer_storeMark(mark, value) ((mark) = (uint8_t)(value))
+#endif
+
+/*
+ * @brief Marks the first byte of a pushed record with a timestamp. Called by the producer before publishing.
+ * @param bufferObject The buffer object handler.
+ * @param len Size of the record.
+ */
+static inline void CircularBuffer_tracePush(CircularBufferObject_t * const bufferObject, const uint16_t len) {
+	CircularBufferDwellTrace_t * const trace = &bufferObject->dwellTrace;
+
+	// Records are sampled while a mark is free.
+	const uint8_t head = trace->head;
+	if ((uint8_t)(head - CircularBuffer_loadMark(trace->tail)) < CIRCULARBUFFER_DWELLTRACE_MARKS) {
+		const uint8_t mark = head & (CIRCULARBUFFER_DWELLTRACE_MARKS - 1);
+		trace->position[mark] = trace->pushed;
+		trace->timestamp[mark] = CIRCULARBUFFER_TIMESTAMP();
+		CircularBuffer_storeMark(trace->head, head + 1);
+	}
+	trace->pushed += len;
+}
+
+/*
+ * @brief Records the dwell time of the marked records that were consumed. Called by the consumer.
+ * @param bufferObject The buffer object handler.
+ * @param len Number of bytes consumed.
+ */
+static inline void CircularBuffer_tracePop(CircularBufferObject_t * const bufferObject, const uint16_t len) {
+	CircularBufferDwellTrace_t * const trace = &bufferObject->dwellTrace;
+	trace->popped += len;
+
+	// Bucket i holds dwell times in [2^(i-1), 2^i) ticks.
+	uint8_t tail = trace->tail;
+	while ((tail != CircularBuffer_loadMark(trace->head)) && ((int32_t)(trace->popped - trace->position[tail & (CIRCULARBUFFER_DWELLTRACE_MARKS - 1)]) > 0)) {
+		const uint32_t dwell = CIRCULARBUFFER_TIMESTAMP() - trace->timestamp[tail & (CIRCULARBUFFER_DWELLTRACE_MARKS - 1)];
+		trace->histogram[dwell ? (32 - __builtin_clz(dwell)) : 0]++;
+		tail++;
+		CircularBuffer_storeMark(trace->tail, tail);
+	}
+}
+#else
+#define CircularBuffer_tracePush(bufferObject, len) ((void)0)
+#define CircularBuffer_tracePop(bufferObject, len) ((void)0)
+#endif
+
+// Fault flag, set by the producer and taken by the consumer. Atomic on multiple cores and masked on a single core, so
+// a fault set between the check and the clear is kept for the next check.
+#if CIRCULARBUFFER_SMP || CIRCULARBUFFER_TSAN
+#define CircularBuffer_loadFault(bufferObject) __atomic_load_n(&(bufferObject)->faultFlag, __ATOMIC_RELAXED)
+#define CircularBuffer_storeFault(bufferObject, fault) __atomic_store_n(&(bufferObject)->faultFlag, (uint16_t)(fault), __ATOMIC_RELAXED)
+#define CircularBuffer_takeFault(bufferObject) (__atomic_exchange_n(&(bufferObject)->faultFlag, 0, __ATOMIC_RELAXED) != 0)
+#else
+#define CircularBuffer_loadFault(bufferObject) (*(volatile uint16_t *)&(bufferObject)->faultFlag)
+#define CircularBuffer_storeFault(bufferObject, fault) (*(volatile uint16_t *)&(bufferObject)->faultFlag = (uint16_t)(fault))
+
+/*
+ * @brief Takes the fault flag with the interrupts masked.
+ * @param bufferObject The buffer object handler.
+ * @return True if the fault flag was set.
+ */
+static inline bool CircularBuffer_takeFault(CircularBufferObject_t * const bufferObject) {
+	uint32_t primask;
+	CIRCULARBUFFER_CRITICAL_ENTER(primask);
+	const uint16_t fault = bufferObject->faultFlag;
+	bufferObject->faultFlag = 0;
+	CIRCULARBUFFER_CRITICAL_EXIT(primask);
+	return fault != 0;
+}
+#endif
+
+// Watermark state, set by the producer and cleared by the consumer. Each edge is taken by an atomic exchange on
+// multiple cores and by a masked exchange on a single core, so only one side reports it.
+#if CIRCULARBUFFER_SMP || CIRCULARBUFFER_TSAN
+#define CircularBuffer_loadWatermark(bufferObject) __atomic_load_n(&(bufferObject)->watermarkHigh, __ATOMIC_ACQUIRE)
+#define CircularBuffer_exchangeWatermark(bufferObject, high) __atomic_exchange_n(&(bufferObject)->watermarkHigh, (high), __ATOMIC_ACQ_REL)
+#else
+#define CircularBuffer_loadWatermark(bufferObject) (*(volatile bool *)&(bufferObject)->watermarkHigh)
+
+/*
+ * @brief Exchanges the watermark state with the interrupts masked.
+ * @param bufferObject The buffer object handler.
+ * @param high The new watermark state.
+ * @return The previous watermark state.
+ */
+static inline bool CircularBuffer_exchangeWatermark(CircularBufferObject_t * const bufferObject, const bool high) {
+	uint32_t primask;
+	CIRCULARBUFFER_CRITICAL_ENTER(primask);
+	const bool previous = bufferObject->watermarkHigh;
+	bufferObject->watermarkHigh = high;
+	CIRCULARBUFFER_CRITICAL_EXIT(primask);
+	return previous;
+}
+#endif
+
+/*
+ * @brief Reports a watermark edge. The other side may take the opposite edge while the callback runs, so the state is
+ *        reported again until the last report matches it.
+ * @param bufferObject The buffer object handler.
+ * @param high The edge that was taken.
+ */
+static void CircularBuffer_reportWatermark(CircularBufferObject_t * const bufferObject, bool high) {
+	const CircularBufferWatermarkCallback_t callback = bufferObject->watermarkCallback;
+	for (;;) {
+		callback(bufferObject, high);
+		const bool current = CircularBuffer_loadWatermark(bufferObject);
+		if (current == high) {
+			return;
+		}
+		high = current;
+	}
+}
+
+/*
+ * @brief Fires the high watermark callback if the unread size reached the high watermark. Called by the producer side.
+ * @param bufferObject The buffer object handler.
+ */
+static inline void CircularBuffer_checkHighWatermark(CircularBufferObject_t * const bufferObject) {
+	// Edge-triggered, stays high until the unread size drops to the low watermark.
+	if (bufferObject->watermarkCallback && !CircularBuffer_loadWatermark(bufferObject) && (CircularBuffer_getUnreadSize(bufferObject) >= bufferObject->highWatermark)
+		&& !CircularBuffer_exchangeWatermark(bufferObject, true)) {
+		CircularBuffer_reportWatermark(bufferObject, true);
+	}
+}
+
+/*
+ * @brief Fires the low watermark callback if the unread size dropped to the low watermark. Called by the consumer side.
+ * @param bufferObject The buffer object handler.
+ */
+static inline void CircularBuffer_checkLowWatermark(CircularBufferObject_t * const bufferObject) {
+	// Edge-triggered, stays low until the unread size reaches the high watermark.
+	if (bufferObject->watermarkCallback && CircularBuffer_loadWatermark(bufferObject) && (CircularBuffer_getUnreadSize(bufferObject) <= bufferObject->lowWatermark)
+		&& CircularBuffer_exchangeWatermark(bufferObject, false)) {
+		CircularBuffer_reportWatermark(bufferObject, false);
+	}
+}
+
 /*
  * @brief Initializes a circular buffer object using the provided memory space.
  * @param bufferObject The buffer object handler.
@@ -37,19 +382,47 @@
  * @param length_2N Size of the buffer memory, i.e. 8 indicates 2^8=256 bytes.
  */
 void CircularBuffer_init(CircularBufferObject_t * const bufferObject, uint8_t * const bufferMemory, const uint8_t length_2N) {
+	// Size is limited to 2^16.
+	assert(length_2N <= 16);
+
+	// Initialize with the power of 2 length.
+	CircularBuffer_initWithLength(bufferObject, bufferMemory, length_2N ? (0x0001UL << length_2N) : 0);
+}
+
+/*
+ * @brief Initializes a circular buffer object of any length using the provided memory space.
+ * @param bufferObject The buffer object handler.
+ * @param bufferMemory The memory space for the buffer.
+ * @param length Size of the buffer memory in bytes, up to 2^16. The buffer holds up to length-1 bytes.
+ */
+void CircularBuffer_initWithLength(CircularBufferObject_t * const bufferObject, uint8_t * const bufferMemory, const uint32_t length) {
 	// Buffer check.
 	assert(bufferObject);
 
 	// Size is limited to 2^16.
-	assert(length_2N <= 16);
+	assert(length <= 0x10000UL);
+#if !CIRCULARBUFFER_ANYLENGTH
+	assert(!(length & (length - 1)));
+#endif
 
-	// Initialize the struct.
+	// Initialize the struct, the mask is set only for power of 2 lengths.
 	bufferObject->memory = (uint8_t *)bufferMemory;
-	bufferObject->lengthMask = (0x0001UL << length_2N) - 1;
-	bufferObject->length = length_2N ? (uint32_t)bufferObject->lengthMask + 1 : 0;
+	bufferObject->capacity = length ? (uint16_t)(length - 1) : 0;
+	bufferObject->lengthMask = (length & (length - 1)) ? 0 : bufferObject->capacity;
+	bufferObject->length = length;
 	bufferObject->faultFlag = false;
 	bufferObject->front = 0;
 	bufferObject->back = 0;
+	bufferObject->highWatermark = 0;
+	bufferObject->lowWatermark = 0;
+	bufferObject->watermarkHigh = false;
+	bufferObject->watermarkCallback = NULL;
+#if CIRCULARBUFFER_STATISTICS
+	memset(&bufferObject->statistics, 0, sizeof(bufferObject->statistics));
+#endif
+#if CIRCULARBUFFER_DWELLTRACE
+	memset(&bufferObject->dwellTrace, 0, sizeof(bufferObject->dwellTrace));
+#endif
 }
 
 /*
@@ -63,10 +436,10 @@ uint16_t CircularBuffer_getUnreadSize(const CircularBufferObject_t * const buffe
 
 	// Get snapshot.
 	CircularBufferPointers_t cachedPointers;
-	*((uint32_t *)&cachedPointers) = *((uint32_t *)bufferObject);
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
 
 	// Return the difference.
-	return (cachedPointers.back - cachedPointers.front) & bufferObject->lengthMask;
+	return CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back);
 }
 
 /*
@@ -81,14 +454,26 @@ bool CircularBuffer_checkAndClearFault(CircularBufferObject_t * const bufferObje
 
 	// Clear the buffer.
 	if(clearBuffer){
+		// Get snapshot, bytes pushed after it stay unread.
+		CircularBufferPointers_t cachedPointers;
+		cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+		// Count the discarded bytes.
+		const uint16_t cleared = CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back);
+		CircularBuffer_count(bufferObject, clearedBytes, cleared);
+		CircularBuffer_tracePop(bufferObject, cleared);
+		(void)cleared;
+
 		// New front is back.
-		bufferObject->front = bufferObject->back;
+		CircularBuffer_storePointer(bufferObject->front, cachedPointers.back);
+
+		// Buffer is empty now.
+		CircularBuffer_checkLowWatermark(bufferObject);
 	}
 
-	// Check fault.
-	if (bufferObject->faultFlag) {
-		// Clear the flag.
-		bufferObject->faultFlag = false;
+	// Check and clear fault.
+	if (CircularBuffer_takeFault(bufferObject)) {
+		CircularBuffer_probe1(fault_clear, bufferObject);
 
 		// There was fault.
 		return true;
@@ -110,14 +495,24 @@ bool CircularBuffer_pushBackByte(CircularBufferObject_t * const bufferObject, co
 
 	// Get unread byte count.
 	uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	CircularBuffer_probe3(push_entry, bufferObject, 1, unread);
 
 	// Buffer space is available.
-	if (unread < bufferObject->lengthMask) {
+	if (unread < bufferObject->capacity) {
 		// Write to back.
 		bufferObject->memory[bufferObject->back] = data;
+		CircularBuffer_tracePush(bufferObject, 1);
 
 		// Advance the back pointer.
-		bufferObject->back = (bufferObject->back + 1) & bufferObject->lengthMask;
+		CircularBuffer_storePointer(bufferObject->back, CircularBuffer_next(bufferObject, bufferObject->back));
+
+		// Update statistics.
+		CircularBuffer_count(bufferObject, pushedBytes, 1);
+		CircularBuffer_countUnread(bufferObject, unread + 1);
+
+		// Check occupancy.
+		CircularBuffer_checkHighWatermark(bufferObject);
+		CircularBuffer_probe3(push_return, bufferObject, 1, unread + 1);
 
 		// Success.
 		return true;
@@ -126,7 +521,14 @@ bool CircularBuffer_pushBackByte(CircularBufferObject_t * const bufferObject, co
 	// No space left.
 	else {
 		// Set fault flag and result.
-		bufferObject->faultFlag = true;
+		CircularBuffer_probe3(full, bufferObject, 1, unread);
+		if (!CircularBuffer_loadFault(bufferObject)) {
+			CircularBuffer_probe1(fault_set, bufferObject);
+		}
+		CircularBuffer_storeFault(bufferObject, true);
+
+		// Update statistics.
+		CircularBuffer_count(bufferObject, droppedBytes, 1);
 	}
 
 	// Failure.
@@ -143,13 +545,31 @@ bool CircularBuffer_popFrontByte(CircularBufferObject_t * const bufferObject, ui
 	// Buffer check.
 	assert(bufferObject && bufferObject->memory);
 
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	if (CircularBuffer_probeActive(pop_entry)) {
+		CircularBuffer_probe3(pop_entry, bufferObject, 1, CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back));
+	}
+
 	// Check data availability.
-	if(bufferObject->back != bufferObject->front){
+	if(cachedPointers.back != cachedPointers.front){
 		// Read from front.
-		*data = bufferObject->memory[bufferObject->front];
+		*data = bufferObject->memory[cachedPointers.front];
 
 		// Advance the back pointer.
-		bufferObject->front = (bufferObject->front + 1) & bufferObject->lengthMask;
+		CircularBuffer_storePointer(bufferObject->front, CircularBuffer_next(bufferObject, cachedPointers.front));
+
+		// Update statistics.
+		CircularBuffer_count(bufferObject, poppedBytes, 1);
+		CircularBuffer_tracePop(bufferObject, 1);
+
+		// Check occupancy.
+		CircularBuffer_checkLowWatermark(bufferObject);
+		if (CircularBuffer_probeActive(pop_return)) {
+			CircularBuffer_probe3(pop_return, bufferObject, 1, CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back) - 1);
+		}
 
 		// Success.
 		return true;
@@ -171,7 +591,9 @@ uint16_t CircularBuffer_pushBack(CircularBufferObject_t * const bufferObject, co
 	assert(bufferObject && bufferObject->memory);
 
 	// Get the free size.
-	uint16_t lenTotal = bufferObject->lengthMask - CircularBuffer_getUnreadSize(bufferObject);
+	const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	uint16_t lenTotal = bufferObject->capacity - unread;
+	CircularBuffer_probe3(push_entry, bufferObject, maxlen, unread);
 
 	// Limit the total count by client buffer size.
 	if(lenTotal > maxlen){
@@ -180,27 +602,26 @@ uint16_t CircularBuffer_pushBack(CircularBufferObject_t * const bufferObject, co
 
 	// Actual number of bytes to write.
 	uint16_t actualLen = lenTotal;
+	if(actualLen){
+		CircularBuffer_tracePush(bufferObject, actualLen);
+	}
 
-	// Copy in 1 or 2 parts [OOoooOOO] -> [oooooOOO] + [OOoooooo].
-	while(lenTotal > 0){
-		// Limit the transfer by the end of the buffer.
-		uint16_t partialLen = lenTotal;
-		if((bufferObject->length - bufferObject->back) < partialLen) {
-			partialLen = bufferObject->length - bufferObject->back;
-		}
-
-		// Copy actual bytes.
-		memcpy(&bufferObject->memory[bufferObject->back], data, partialLen);
-
-		// Move the back pointer forward.
-		bufferObject->back = (bufferObject->back + partialLen) & bufferObject->lengthMask;
+	// Copy and move the back pointer forward.
+	if(actualLen){
+		CircularBuffer_storePointer(bufferObject->back, CircularBuffer_copyIn(bufferObject, bufferObject->back, data, actualLen));
+	}
 
-		// Substract the read bytes.
-		lenTotal -= partialLen;
+	// Update statistics.
+	CircularBuffer_count(bufferObject, pushedBytes, actualLen);
+	CircularBuffer_count(bufferObject, shortPushes, actualLen < maxlen);
+	CircularBuffer_countUnread(bufferObject, unread + actualLen);
 
-		// Iterate our buffer pointer;
-		data += partialLen;
+	// Check occupancy.
+	CircularBuffer_checkHighWatermark(bufferObject);
+	if (actualLen < maxlen) {
+		CircularBuffer_probe3(full, bufferObject, maxlen - actualLen, unread + actualLen);
 	}
+	CircularBuffer_probe3(push_return, bufferObject, actualLen, unread + actualLen);
 
 	// Return count of actual written bytes.
 	return actualLen;
@@ -218,7 +639,9 @@ uint16_t CircularBuffer_popFront(CircularBufferObject_t * const bufferObject, ui
 	assert(bufferObject && bufferObject->memory);
 
 	// Get available count.
-	uint16_t lenTotal = CircularBuffer_getUnreadSize(bufferObject);
+	const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	uint16_t lenTotal = unread;
+	CircularBuffer_probe3(pop_entry, bufferObject, maxlen, unread);
 
 	// Limit the total count by client buffer size.
 	if(lenTotal > maxlen){
@@ -228,27 +651,522 @@ uint16_t CircularBuffer_popFront(CircularBufferObject_t * const bufferObject, ui
 	// Actual number of bytes to read.
 	uint16_t actualLen = lenTotal;
 
-	// Copy in 1 or 2 parts [OOoooOOO] -> [oooooOOO] + [OOoooooo].
-	while(lenTotal > 0){
-		// Limit the transfer by the end of the buffer.
-		uint16_t partialLen = lenTotal;
-		if((bufferObject->length - bufferObject->front) < partialLen) {
-			partialLen = bufferObject->length - bufferObject->front;
+	// Copy and move the front pointer forward.
+	if(actualLen){
+		CircularBuffer_storePointer(bufferObject->front, CircularBuffer_copyOut(bufferObject, bufferObject->front, data, actualLen));
+	}
+
+	// Update statistics.
+	CircularBuffer_count(bufferObject, poppedBytes, actualLen);
+	CircularBuffer_tracePop(bufferObject, actualLen);
+
+	// Check occupancy.
+	CircularBuffer_checkLowWatermark(bufferObject);
+	CircularBuffer_probe3(pop_return, bufferObject, actualLen, unread - actualLen);
+
+	// Return count of actual read bytes.
+	return actualLen;
+}
+
+/*
+ * @brief Push-back the pieces of a vector in order, with a single space check and a single back pointer update.
+ * @param bufferObject The buffer object handler.
+ * @param vector Array of the pieces to push.
+ * @param count Number of pieces.
+ * @param allOrNothing If true nothing is pushed unless all pieces fit, otherwise pushes until the buffer is full.
+ * @return Actual bytes pushed to the buffer.
+ */
+uint16_t CircularBuffer_pushBackV(CircularBufferObject_t * const bufferObject, const CircularBufferVector_t * const vector, const uint16_t count, const bool allOrNothing) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && (vector || !count));
+
+	// Get the free size and the total size.
+	const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	const uint16_t free = bufferObject->capacity - unread;
+	uint32_t total = 0;
+	for (uint16_t i = 0; i < count; i++) {
+		total += vector[i].len;
+	}
+	CircularBuffer_probe3(push_entry, bufferObject, total, unread);
+
+	// Limit the total count by the free size, or refuse all.
+	uint16_t actualLen = (total > free) ? free : (uint16_t)total;
+	if (allOrNothing && (actualLen < total)) {
+		actualLen = 0;
+	}
+	if (actualLen) {
+		CircularBuffer_tracePush(bufferObject, actualLen);
+
+		// Copy the pieces, then move the back pointer forward once.
+		uint16_t back = bufferObject->back;
+		uint16_t lenTotal = actualLen;
+		for (uint16_t i = 0; lenTotal > 0; i++) {
+			const uint16_t partialLen = (vector[i].len < lenTotal) ? vector[i].len : lenTotal;
+			back = CircularBuffer_copyIn(bufferObject, back, vector[i].data, partialLen);
+			lenTotal -= partialLen;
 		}
+		CircularBuffer_storePointer(bufferObject->back, back);
+	}
+
+	// Update statistics.
+	CircularBuffer_count(bufferObject, pushedBytes, actualLen);
+	CircularBuffer_count(bufferObject, shortPushes, actualLen < total);
+	CircularBuffer_countUnread(bufferObject, unread + actualLen);
+
+	// Check occupancy.
+	CircularBuffer_checkHighWatermark(bufferObject);
+	if (actualLen < total) {
+		CircularBuffer_probe3(full, bufferObject, total - actualLen, unread + actualLen);
+	}
+	CircularBuffer_probe3(push_return, bufferObject, actualLen, unread + actualLen);
 
-		// Copy actual bytes.
-		memcpy(data, &bufferObject->memory[bufferObject->front], partialLen);
+	// Return count of actual written bytes.
+	return actualLen;
+}
 
-		// Move the front pointer forward.
-		bufferObject->front = (bufferObject->front + partialLen) & bufferObject->lengthMask;
+/*
+ * @brief Pop-front into the pieces of a vector in order until all are full or the buffer is empty, with a single
+ *        front pointer update.
+ * @param bufferObject The buffer object handler.
+ * @param vector Array of the pieces to fill.
+ * @param count Number of pieces.
+ * @return Actual bytes popped from the buffer.
+ */
+uint16_t CircularBuffer_popFrontV(CircularBufferObject_t * const bufferObject, const CircularBufferVector_t * const vector, const uint16_t count) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && (vector || !count));
 
-		// Substract the read bytes.
-		lenTotal -= partialLen;
+	// Get available count.
+	const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	uint32_t total = 0;
+	for (uint16_t i = 0; i < count; i++) {
+		total += vector[i].len;
+	}
+	CircularBuffer_probe3(pop_entry, bufferObject, total, unread);
 
-		// Iterate our buffer pointer;
-		data += partialLen;
+	// Limit the total count by the unread size.
+	const uint16_t actualLen = (total > unread) ? unread : (uint16_t)total;
+	if (actualLen) {
+		// Copy into the pieces, then move the front pointer forward once.
+		uint16_t front = bufferObject->front;
+		uint16_t lenTotal = actualLen;
+		for (uint16_t i = 0; lenTotal > 0; i++) {
+			const uint16_t partialLen = (vector[i].len < lenTotal) ? vector[i].len : lenTotal;
+			front = CircularBuffer_copyOut(bufferObject, front, vector[i].data, partialLen);
+			lenTotal -= partialLen;
+		}
+		CircularBuffer_storePointer(bufferObject->front, front);
 	}
 
+	// Update statistics.
+	CircularBuffer_count(bufferObject, poppedBytes, actualLen);
+	CircularBuffer_tracePop(bufferObject, actualLen);
+
+	// Check occupancy.
+	CircularBuffer_checkLowWatermark(bufferObject);
+	CircularBuffer_probe3(pop_return, bufferObject, actualLen, unread - actualLen);
+
 	// Return count of actual read bytes.
 	return actualLen;
 }
+
+/*
+ * @brief Reads an unread byte at an offset from the front without consuming it.
+ * @param bufferObject The buffer object handler.
+ * @param offset Offset from the front, 0 is the next byte to pop.
+ * @param data Pointer to byte to write the data.
+ * @return Returns true on success, false if the offset is not below the unread size.
+ */
+bool CircularBuffer_peekAt(const CircularBufferObject_t * const bufferObject, const uint16_t offset, uint8_t * const data) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && data);
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Offset check.
+	if (offset >= CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back)) {
+		return false;
+	}
+
+	// Read across the wrap.
+	*data = bufferObject->memory[CircularBuffer_wrap(bufferObject, (uint32_t)cachedPointers.front + offset)];
+	return true;
+}
+
+/*
+ * @brief Copies unread data at an offset from the front without consuming it.
+ * @param bufferObject The buffer object handler.
+ * @param offset Offset from the front, 0 is the next byte to pop.
+ * @param data Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @return Actual bytes copied, limited by the unread size after the offset.
+ */
+uint16_t CircularBuffer_peek(const CircularBufferObject_t * const bufferObject, const uint16_t offset, uint8_t * const data, const uint16_t maxlen) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory);
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Limit the total count by the unread size after the offset and the client buffer size.
+	const uint16_t unread = CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back);
+	if (offset >= unread) {
+		return 0;
+	}
+	const uint16_t len = (unread - offset < maxlen) ? unread - offset : maxlen;
+
+	// Copy in 1 or 2 parts, the front pointer is not moved.
+	if (len) {
+		CircularBuffer_copyOut(bufferObject, CircularBuffer_wrap(bufferObject, (uint32_t)cachedPointers.front + offset), data, len);
+	}
+	return len;
+}
+
+/*
+ * @brief Discards unread data at the front, i.e. after it was parsed in place with peek.
+ * @param bufferObject The buffer object handler.
+ * @param maxlen Number of bytes to discard.
+ * @return Actual bytes discarded, limited by the unread size.
+ */
+uint16_t CircularBuffer_skip(CircularBufferObject_t * const bufferObject, const uint16_t maxlen) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory);
+
+	// Limit the count by the unread size.
+	const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+	const uint16_t len = (unread < maxlen) ? unread : maxlen;
+
+	// Consume.
+	if (len) {
+		CircularBuffer_advanceFront(bufferObject, len);
+	}
+	return len;
+}
+
+/*
+ * @brief Gets the contiguous unread span at the front, i.e. the data that can be read without wrapping.
+ * @param bufferObject The buffer object handler.
+ * @param data Pointer to write the start address of the span.
+ * @return Size of the contiguous unread span in bytes.
+ */
+uint16_t CircularBuffer_getFrontSpan(const CircularBufferObject_t * const bufferObject, const uint8_t ** const data) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && data);
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Span starts at the front.
+	*data = &bufferObject->memory[cachedPointers.front];
+
+	// Span ends at the back or at the end of the memory if the data wraps.
+	if(cachedPointers.back >= cachedPointers.front){
+		return cachedPointers.back - cachedPointers.front;
+	}
+	return bufferObject->length - cachedPointers.front;
+}
+
+/*
+ * @brief Advances the front pointer, i.e. consumes the data that was read in-place via CircularBuffer_getFrontSpan.
+ * @param bufferObject The buffer object handler.
+ * @param len Number of bytes to consume, must not exceed the unread size.
+ */
+void CircularBuffer_advanceFront(CircularBufferObject_t * const bufferObject, const uint16_t len) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory);
+
+	// Length check.
+	assert(len <= CircularBuffer_getUnreadSize(bufferObject));
+
+	// Move the front pointer forward.
+	CircularBuffer_storePointer(bufferObject->front, CircularBuffer_wrap(bufferObject, bufferObject->front + len));
+
+	// Update statistics.
+	CircularBuffer_count(bufferObject, poppedBytes, len);
+	CircularBuffer_tracePop(bufferObject, len);
+	if (CircularBuffer_probeActive(pop_return)) {
+		CircularBuffer_probe3(pop_return, bufferObject, len, CircularBuffer_getUnreadSize(bufferObject));
+	}
+
+	// Check occupancy.
+	CircularBuffer_checkLowWatermark(bufferObject);
+}
+
+/*
+ * @brief Gets the contiguous free span at the back, i.e. the space that can be written without wrapping.
+ * @param bufferObject The buffer object handler.
+ * @param data Pointer to write the start address of the span.
+ * @return Size of the contiguous free span in bytes.
+ */
+uint16_t CircularBuffer_getBackSpan(const CircularBufferObject_t * const bufferObject, uint8_t ** const data) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && data);
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Span starts at the back.
+	*data = &bufferObject->memory[cachedPointers.back];
+
+	// Span ends before the front, one byte is always kept free.
+	if(cachedPointers.front > cachedPointers.back){
+		return cachedPointers.front - cachedPointers.back - 1;
+	}
+
+	// Otherwise at the end of the memory, or before it if the front is at the start.
+	if(!bufferObject->length){
+		return 0;
+	}
+	return bufferObject->length - cachedPointers.back - (cachedPointers.front ? 0 : 1);
+}
+
+/*
+ * @brief Advances the back pointer, i.e. publishes the data that was written in-place via CircularBuffer_getBackSpan.
+ * @param bufferObject The buffer object handler.
+ * @param len Number of bytes to publish, must not exceed the free size.
+ */
+void CircularBuffer_advanceBack(CircularBufferObject_t * const bufferObject, const uint16_t len) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory);
+
+	// Length check.
+	assert(len <= (uint16_t)(bufferObject->capacity - CircularBuffer_getUnreadSize(bufferObject)));
+
+	// Move the back pointer forward.
+	if(len){
+		CircularBuffer_tracePush(bufferObject, len);
+	}
+	CircularBuffer_storePointer(bufferObject->back, CircularBuffer_wrap(bufferObject, bufferObject->back + len));
+
+	// Update statistics.
+	CircularBuffer_count(bufferObject, pushedBytes, len);
+	CircularBuffer_countUnread(bufferObject, CircularBuffer_getUnreadSize(bufferObject));
+	if (CircularBuffer_probeActive(push_return)) {
+		CircularBuffer_probe3(push_return, bufferObject, len, CircularBuffer_getUnreadSize(bufferObject));
+	}
+
+	// Check occupancy.
+	CircularBuffer_checkHighWatermark(bufferObject);
+}
+
+/*
+ * @brief Sets the occupancy watermarks, i.e. for flow control. The callback is invoked from the pushing context
+ *        with high=true when the unread size reaches the high watermark, and from the popping context with
+ *        high=false when it drops back to the low watermark. If both edges race, a context may repeat the callback
+ *        with the latest state, so the callback must be idempotent, i.e. drive a pin to a level.
+ * @param bufferObject The buffer object handler.
+ * @param high The high watermark in bytes.
+ * @param low The low watermark in bytes, must be less than high.
+ * @param callback The callback to invoke on crossings, NULL to disable.
+ */
+void CircularBuffer_setWatermarks(CircularBufferObject_t * const bufferObject, const uint16_t high, const uint16_t low, const CircularBufferWatermarkCallback_t callback) {
+	// Buffer check.
+	assert(bufferObject);
+
+	// Watermark check.
+	assert(!callback || (low < high));
+
+	// Disable while updating.
+	bufferObject->watermarkCallback = NULL;
+	bufferObject->highWatermark = high;
+	bufferObject->lowWatermark = low;
+	__atomic_store_n(&bufferObject->watermarkHigh, false, __ATOMIC_RELAXED);
+	bufferObject->watermarkCallback = callback;
+}
+
+/*
+ * @brief Gets a snapshot of the statistics counters. Counters are free-running, i.e. export deltas to metrics.
+ *        All counters read 0 unless built with CIRCULARBUFFER_STATISTICS.
+ * @param bufferObject The buffer object handler.
+ * @param statistics Pointer to write the snapshot.
+ */
+void CircularBuffer_getStatistics(const CircularBufferObject_t * const bufferObject, CircularBufferStatistics_t * const statistics) {
+	// Buffer check.
+	assert(bufferObject && statistics);
+
+#if CIRCULARBUFFER_STATISTICS
+	// Copy the counters one by one. Each one is read whole, but both sides may count in between, so the snapshot is
+	// not consistent across counters.
+	statistics->pushedBytes = CircularBuffer_loadCounter(bufferObject, pushedBytes);
+	statistics->droppedBytes = CircularBuffer_loadCounter(bufferObject, droppedBytes);
+	statistics->shortPushes = CircularBuffer_loadCounter(bufferObject, shortPushes);
+	statistics->maxUnread = CircularBuffer_loadCounter(bufferObject, maxUnread);
+	statistics->poppedBytes = CircularBuffer_loadCounter(bufferObject, poppedBytes);
+	statistics->clearedBytes = CircularBuffer_loadCounter(bufferObject, clearedBytes);
+#else
+	// Not counted.
+	memset(statistics, 0, sizeof(*statistics));
+#endif
+}
+
+/*
+ * @brief Gets the dwell time histogram, i.e. how long pushed records waited until popped.
+ *        Bucket i counts dwell times in [2^(i-1), 2^i) CIRCULARBUFFER_TIMESTAMP ticks, bucket 0 counts zero.
+ *        All buckets read 0 unless built with CIRCULARBUFFER_DWELLTRACE.
+ * @param bufferObject The buffer object handler.
+ * @param histogram Memory to write CIRCULARBUFFER_DWELLTRACE_BUCKETS counters.
+ */
+void CircularBuffer_getDwellHistogram(const CircularBufferObject_t * const bufferObject, uint32_t * const histogram) {
+	// Buffer check.
+	assert(bufferObject && histogram);
+
+#if CIRCULARBUFFER_DWELLTRACE
+	// Copy the buckets.
+	memcpy(histogram, (const uint32_t *)bufferObject->dwellTrace.histogram, sizeof(bufferObject->dwellTrace.histogram));
+#else
+	// Not traced.
+	memset(histogram, 0, CIRCULARBUFFER_DWELLTRACE_BUCKETS * sizeof(uint32_t));
+#endif
+}
+
+/*
+ * @brief Copies the buffer without consuming it, i.e. for a crash dump: a CircularBufferSnapshot_t header followed by
+ *        the newest unread data in order. The data is copied in 1 or 2 parts while the producer and the consumer may
+ *        be running. The front is read again after the copy, and the bytes it passed meanwhile are dropped, because
+ *        the producer may have overwritten them. The snapshot is consistent unless the consumer pops a whole buffer
+ *        length during the copy.
+ * @param bufferObject The buffer object handler.
+ * @param snapshot Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @return Size of the snapshot in bytes, 0 if the output memory is smaller than the header.
+ */
+uint32_t CircularBuffer_snapshot(const CircularBufferObject_t * const bufferObject, uint8_t * const snapshot, const uint32_t maxlen) {
+	CircularBufferSnapshot_t header;
+
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && snapshot);
+
+	// Size check.
+	if (maxlen < sizeof(header)) {
+		return 0;
+	}
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Keep the newest data that fits.
+	const uint16_t unread = CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back);
+	const uint16_t skipped = (unread > maxlen - sizeof(header)) ? (uint16_t)(unread - (maxlen - sizeof(header))) : 0;
+	uint16_t len = unread - skipped;
+	uint8_t * const data = &snapshot[sizeof(header)];
+	if (len) {
+		CircularBuffer_copyOut(bufferObject, CircularBuffer_wrap(bufferObject, (uint32_t)cachedPointers.front + skipped), data, len);
+	}
+
+	// Read the front again after the copy and drop what the consumer released meanwhile.
+	CircularBuffer_orderLoads();
+	CircularBufferPointers_t currentPointers;
+	currentPointers = CircularBuffer_loadSnapshot(bufferObject);
+	const uint16_t consumed = CircularBuffer_distance(bufferObject, cachedPointers.front, currentPointers.front);
+	if (consumed > skipped) {
+		const uint16_t released = consumed - skipped;
+		if (released >= len) {
+			len = 0;
+		} else {
+			len -= released;
+			memmove(data, &data[released], len);
+		}
+	}
+
+	// Header.
+	header.length = bufferObject->length;
+	header.unread = len;
+	header.faultFlag = CircularBuffer_loadFault(bufferObject);
+	memcpy(snapshot, &header, sizeof(header));
+	return sizeof(header) + len;
+}
+
+/*
+ * @brief Restores a snapshot into a buffer, i.e. for a warm restart. The buffer may have a different length, if the
+ *        data fits. Its unread data is discarded. Neither the producer nor the consumer may run during the restore.
+ * @param bufferObject The buffer object handler.
+ * @param snapshot Pointer to the snapshot.
+ * @param len Size of the snapshot.
+ * @return Returns true on success, false if the snapshot is truncated or does not fit.
+ */
+bool CircularBuffer_restore(CircularBufferObject_t * const bufferObject, const uint8_t * const snapshot, const uint32_t len) {
+	CircularBufferSnapshot_t header;
+
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && snapshot);
+
+	// Snapshot check.
+	if (len < sizeof(header)) {
+		return false;
+	}
+	memcpy(&header, snapshot, sizeof(header));
+	if ((len - sizeof(header) < header.unread) || (header.unread > bufferObject->capacity)) {
+		return false;
+	}
+
+	// Discard the unread data.
+	const uint16_t cleared = CircularBuffer_getUnreadSize(bufferObject);
+	CircularBuffer_count(bufferObject, clearedBytes, cleared);
+	CircularBuffer_tracePop(bufferObject, cleared);
+	(void)cleared;
+
+	// Copy in 1 part from the start of the memory.
+	memcpy(bufferObject->memory, &snapshot[sizeof(header)], header.unread);
+	CircularBuffer_storePointer(bufferObject->front, 0);
+	CircularBuffer_storePointer(bufferObject->back, header.unread);
+	CircularBuffer_storeFault(bufferObject, header.faultFlag);
+
+	// Update statistics.
+	CircularBuffer_count(bufferObject, pushedBytes, header.unread);
+	CircularBuffer_countUnread(bufferObject, header.unread);
+	CircularBuffer_tracePush(bufferObject, header.unread);
+
+	// Check occupancy.
+	CircularBuffer_checkHighWatermark(bufferObject);
+	CircularBuffer_checkLowWatermark(bufferObject);
+	return true;
+}
+
+/*
+ * @brief Checks the internal consistency of a buffer, i.e. from a test harness or an assert after suspected memory
+ *        corruption. With CIRCULARBUFFER_STATISTICS the byte counters must also add up to the unread size, which
+ *        holds only while neither side is inside a call.
+ * @param bufferObject The buffer object handler.
+ * @return Returns true if the buffer is consistent.
+ */
+bool CircularBuffer_checkInvariants(const CircularBufferObject_t * const bufferObject) {
+	// Buffer check.
+	assert(bufferObject);
+
+	// Get snapshot.
+	CircularBufferPointers_t cachedPointers;
+	cachedPointers = CircularBuffer_loadSnapshot(bufferObject);
+
+	// Geometry.
+	if ((bufferObject->length > 0x10000UL) || (bufferObject->capacity != (bufferObject->length ? bufferObject->length - 1 : 0))) {
+		return false;
+	}
+	if (bufferObject->lengthMask != ((bufferObject->length & (bufferObject->length - 1)) ? 0 : bufferObject->capacity)) {
+		return false;
+	}
+	if (bufferObject->length && !bufferObject->memory) {
+		return false;
+	}
+
+	// Pointers stay within the memory.
+	if (bufferObject->length ? ((cachedPointers.back >= bufferObject->length) || (cachedPointers.front >= bufferObject->length))
+		: (cachedPointers.back || cachedPointers.front)) {
+		return false;
+	}
+
+#if CIRCULARBUFFER_STATISTICS
+	// Every pushed byte was popped, cleared or is unread.
+	if ((uint32_t)(CircularBuffer_loadCounter(bufferObject, pushedBytes) - CircularBuffer_loadCounter(bufferObject, poppedBytes)
+		- CircularBuffer_loadCounter(bufferObject, clearedBytes))
+		!= CircularBuffer_distance(bufferObject, cachedPointers.front, cachedPointers.back)) {
+		return false;
+	}
+#endif
+	return true;
+}
@@ -31,29 +31,301 @@
 
 // Includes.
 #include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+
+// Settings.
+#ifndef CIRCULARBUFFER_SMP
+#define CIRCULARBUFFER_SMP 0
+#endif
+#ifndef CIRCULARBUFFER_STATISTICS
+#define CIRCULARBUFFER_STATISTICS 0
+#endif
+#ifndef CIRCULARBUFFER_DWELLTRACE
+#define CIRCULARBUFFER_DWELLTRACE 0
+#endif
+#ifndef CIRCULARBUFFER_DWELLTRACE_MARKS
+#define CIRCULARBUFFER_DWELLTRACE_MARKS 16
+#endif
+#define CIRCULARBUFFER_DWELLTRACE_BUCKETS 33
+
+// Lengths that are not a power of 2, set to 0 to keep only the masked pointer arithmetic.
+#ifndef CIRCULARBUFFER_ANYLENGTH
+#define CIRCULARBUFFER_ANYLENGTH 1
+#endif
+
+// Inline copy of up to 16 bytes by overlapping word accesses, where unaligned accesses are cheap.
+#ifndef CIRCULARBUFFER_SMALLCOPY
+#if defined(__x86_64__) || defined(__i386__) || defined(__ARM_FEATURE_UNALIGNED)
+#define CIRCULARBUFFER_SMALLCOPY 1
+#else
+#define CIRCULARBUFFER_SMALLCOPY 0
+#endif
+#endif
+
+// ThreadSanitizer builds load the pointers one by one, see CircularBuffer_loadPointersSplit().
+#ifndef CIRCULARBUFFER_TSAN
+#if defined(__SANITIZE_THREAD__)
+#define CIRCULARBUFFER_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define CIRCULARBUFFER_TSAN 1
+#endif
+#endif
+#endif
+#ifndef CIRCULARBUFFER_TSAN
+#define CIRCULARBUFFER_TSAN 0
+#endif
+
+// Timestamp source, 32-bit free-running ticks.
+#ifndef CIRCULARBUFFER_TIMESTAMP
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+// DWT cycle counter, the application enables it via CoreDebug->DEMCR and DWT->CTRL.
+#define CIRCULARBUFFER_TIMESTAMP() (*((volatile uint32_t *)0xE0001004UL))
+#elif defined(__x86_64__) || defined(__i386__)
+#define CIRCULARBUFFER_TIMESTAMP() ((uint32_t)__builtin_ia32_rdtsc())
+#elif defined(__unix__)
+#include <time.h>
+static inline uint32_t CircularBuffer_timestamp(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)ts.tv_sec * 1000000000UL + (uint32_t)ts.tv_nsec;
+}
+#define CIRCULARBUFFER_TIMESTAMP() CircularBuffer_timestamp()
+#endif
+#endif
+
+// Critical section of the single-core read-modify-writes, saves and masks the interrupts. ARMv6-M has no byte
+// exclusives, so an atomic exchange there would call __atomic_exchange_1, which bare-metal links do not provide.
+#ifndef CIRCULARBUFFER_CRITICAL_ENTER
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__)
+#define CIRCULARBUFFER_CRITICAL_ENTER(primask) __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory")
+#define CIRCULARBUFFER_CRITICAL_EXIT(primask) __asm volatile ("msr primask, %0" : : "r" (primask) : "memory")
+#else
+// Single-threaded hosted builds have nothing to mask, only the compiler is kept from reordering.
+#define CIRCULARBUFFER_CRITICAL_ENTER(primask) ((primask) = 0, __atomic_signal_fence(__ATOMIC_SEQ_CST))
+#define CIRCULARBUFFER_CRITICAL_EXIT(primask) ((void)(primask), __atomic_signal_fence(__ATOMIC_SEQ_CST))
+#endif
+#endif
 
 // Type definitions.
 typedef struct{
+	uint32_t pushedBytes;
+	uint32_t droppedBytes;
+	uint32_t shortPushes;
+	uint16_t maxUnread;
+	uint32_t poppedBytes;
+	uint32_t clearedBytes;
+}CircularBufferStatistics_t;
+typedef struct{
+	uint32_t position[CIRCULARBUFFER_DWELLTRACE_MARKS];
+	uint32_t timestamp[CIRCULARBUFFER_DWELLTRACE_MARKS];
+	uint32_t pushed;
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	uint32_t popped;
+	uint32_t histogram[CIRCULARBUFFER_DWELLTRACE_BUCKETS];
+}CircularBufferDwellTrace_t;
+typedef struct CircularBufferObject_s CircularBufferObject_t;
+typedef void (*CircularBufferWatermarkCallback_t)(CircularBufferObject_t * const bufferObject, const bool high);
+struct CircularBufferObject_s{
 	uint16_t back;
 	uint16_t front;
 	uint16_t faultFlag;
 	uint16_t lengthMask;
 	uint32_t length;
 	uint8_t * memory;
-}CircularBufferObject_t;
+	uint16_t capacity;
+	uint16_t highWatermark;
+	uint16_t lowWatermark;
+	bool watermarkHigh;
+	CircularBufferWatermarkCallback_t watermarkCallback;
+#if CIRCULARBUFFER_STATISTICS
+	CircularBufferStatistics_t statistics;
+#endif
+#if CIRCULARBUFFER_DWELLTRACE
+	CircularBufferDwellTrace_t dwellTrace;
+#endif
+};
 typedef struct{
 	uint16_t back;
 	uint16_t front;
 }CircularBufferPointers_t;
+typedef struct{
+	uint8_t * data;
+	uint16_t len;
+}CircularBufferVector_t;
+typedef struct{
+	uint32_t length;
+	uint16_t unread;
+	uint16_t faultFlag;
+}CircularBufferSnapshot_t;
 
 // Prototypes.
 void CircularBuffer_init(CircularBufferObject_t * const bufferObject, uint8_t * const bufferMemory, const uint8_t length_2N);
+void CircularBuffer_initWithLength(CircularBufferObject_t * const bufferObject, uint8_t * const bufferMemory, const uint32_t length);
 uint16_t CircularBuffer_getUnreadSize(const CircularBufferObject_t * const bufferObject);
 bool CircularBuffer_checkAndClearFault(CircularBufferObject_t * const bufferObject, const bool clearBuffer);
 bool CircularBuffer_pushBackByte(CircularBufferObject_t * const bufferObject, const uint8_t data);
 bool CircularBuffer_popFrontByte(CircularBufferObject_t * const bufferObject, uint8_t * const data);
 uint16_t CircularBuffer_pushBack(CircularBufferObject_t * const bufferObject, const uint8_t * const data, const uint16_t maxlen);
 uint16_t CircularBuffer_popFront(CircularBufferObject_t * const bufferObject, uint8_t * data, const uint16_t maxlen);
+uint16_t CircularBuffer_pushBackV(CircularBufferObject_t * const bufferObject, const CircularBufferVector_t * const vector, const uint16_t count, const bool allOrNothing);
+uint16_t CircularBuffer_popFrontV(CircularBufferObject_t * const bufferObject, const CircularBufferVector_t * const vector, const uint16_t count);
+bool CircularBuffer_peekAt(const CircularBufferObject_t * const bufferObject, const uint16_t offset, uint8_t * const data);
+uint16_t CircularBuffer_peek(const CircularBufferObject_t * const bufferObject, const uint16_t offset, uint8_t * const data, const uint16_t maxlen);
+uint16_t CircularBuffer_skip(CircularBufferObject_t * const bufferObject, const uint16_t maxlen);
+uint16_t CircularBuffer_getFrontSpan(const CircularBufferObject_t * const bufferObject, const uint8_t ** const data);
+void CircularBuffer_advanceFront(CircularBufferObject_t * const bufferObject, const uint16_t len);
+uint16_t CircularBuffer_getBackSpan(const CircularBufferObject_t * const bufferObject, uint8_t ** const data);
+void CircularBuffer_advanceBack(CircularBufferObject_t * const bufferObject, const uint16_t len);
+void CircularBuffer_setWatermarks(CircularBufferObject_t * const bufferObject, const uint16_t high, const uint16_t low, const CircularBufferWatermarkCallback_t callback);
+void CircularBuffer_getStatistics(const CircularBufferObject_t * const bufferObject, CircularBufferStatistics_t * const statistics);
+void CircularBuffer_getDwellHistogram(const CircularBufferObject_t * const bufferObject, uint32_t * const histogram);
+bool CircularBuffer_checkInvariants(const CircularBufferObject_t * const bufferObject);
+uint32_t CircularBuffer_snapshot(const CircularBufferObject_t * const bufferObject, uint8_t * const snapshot, const uint32_t maxlen);
+bool CircularBuffer_restore(CircularBufferObject_t * const bufferObject, const uint8_t * const snapshot, const uint32_t len);
+
+// Pointer access of the specialized buffers. Ordered against the data accesses for thread vs. interrupt on a single
+// core by a compiler barrier, or by acquire/release with CIRCULARBUFFER_SMP.
+static inline uint16_t CircularBuffer_loadIndex(const uint16_t * const index) {
+#if CIRCULARBUFFER_SMP
+	return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+#else
+	const uint16_t value = __atomic_load_n(index, __ATOMIC_RELAXED);
+	__atomic_signal_fence(__ATOMIC_ACQUIRE);
+	return value;
+#endif
+}
+static inline void CircularBuffer_storeIndex(uint16_t * const index, const uint16_t value) {
+#if CIRCULARBUFFER_SMP
+	__atomic_store_n(index, value, __ATOMIC_RELEASE);
+#else
+	__atomic_signal_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(index, value, __ATOMIC_RELAXED);
+#endif
+}
+
+/*
+ * @brief Copies the bytes of a push or pop. Up to 16 bytes are copied inline by two overlapping loads and stores of
+ *        the largest word that fits, larger copies call memcpy.
+ * @param destination Pointer to the destination.
+ * @param source Pointer to the source.
+ * @param len Number of bytes.
+ */
+static inline void CircularBuffer_copy(uint8_t * const destination, const uint8_t * const source, const uint16_t len) {
+#if CIRCULARBUFFER_SMALLCOPY
+	// Fixed-size memcpy compiles to a single unaligned load or store.
+	if (len >= 8 && len <= 16) {
+		uint64_t head, tail;
+		memcpy(&head, source, 8);
+		memcpy(&tail, source + len - 8, 8);
+		memcpy(destination, &head, 8);
+		memcpy(destination + len - 8, &tail, 8);
+		return;
+	} else if (len >= 4 && len < 8) {
+		uint32_t head, tail;
+		memcpy(&head, source, 4);
+		memcpy(&tail, source + len - 4, 4);
+		memcpy(destination, &head, 4);
+		memcpy(destination + len - 4, &tail, 4);
+		return;
+	} else if (len >= 2 && len < 4) {
+		uint16_t head, tail;
+		memcpy(&head, source, 2);
+		memcpy(&tail, source + len - 2, 2);
+		memcpy(destination, &head, 2);
+		memcpy(destination + len - 2, &tail, 2);
+		return;
+	} else if (len == 1) {
+		*destination = *source;
+		return;
+	}
+#endif
+	memcpy(destination, source, len);
+}
+
+// Pointer mask of a specialized buffer.
+#define CIRCULARBUFFER_MASK(length_2N) ((uint16_t)((1UL << (length_2N)) - 1))
+
+/*
+ * @brief Defines a statically allocated buffer with the capacity as a compile-time constant and static inline
+ *        name_getUnreadSize(), name_checkAndClearFault(), name_pushBackByte(), name_popFrontByte(), name_pushBack()
+ *        and name_popFront() with the same semantics as the CircularBuffer_* functions. Masks are constant-folded
+ *        and there is no object to load, i.e. for interrupt handlers. Statistics, tracing and watermarks are not
+ *        supported on these buffers.
+ * @param name Prefix of the generated memory, pointers and functions.
+ * @param length_2N Size of the buffer memory, i.e. 8 indicates 2^8=256 bytes, 1 to 16.
+ */
+#define CIRCULARBUFFER_DEFINE(name, length_2N) \
+	static uint8_t name##_memory[1UL << (length_2N)]; \
+	static uint16_t name##_back; \
+	static uint16_t name##_front; \
+	static volatile bool name##_faultFlag; \
+	static inline uint16_t name##_getUnreadSize(void) { \
+		return (uint16_t)(CircularBuffer_loadIndex(&name##_back) - CircularBuffer_loadIndex(&name##_front)) & CIRCULARBUFFER_MASK(length_2N); \
+	} \
+	static inline bool name##_checkAndClearFault(const bool clearBuffer) { \
+		if (clearBuffer) { \
+			CircularBuffer_storeIndex(&name##_front, CircularBuffer_loadIndex(&name##_back)); \
+		} \
+		if (name##_faultFlag) { \
+			name##_faultFlag = false; \
+			return true; \
+		} \
+		return false; \
+	} \
+	static inline bool name##_pushBackByte(const uint8_t data) { \
+		const uint16_t back = name##_back; \
+		if (((uint16_t)(back - CircularBuffer_loadIndex(&name##_front)) & CIRCULARBUFFER_MASK(length_2N)) < CIRCULARBUFFER_MASK(length_2N)) { \
+			name##_memory[back] = data; \
+			CircularBuffer_storeIndex(&name##_back, (uint16_t)(back + 1) & CIRCULARBUFFER_MASK(length_2N)); \
+			return true; \
+		} \
+		name##_faultFlag = true; \
+		return false; \
+	} \
+	static inline bool name##_popFrontByte(uint8_t * const data) { \
+		const uint16_t front = name##_front; \
+		if (CircularBuffer_loadIndex(&name##_back) != front) { \
+			*data = name##_memory[front]; \
+			CircularBuffer_storeIndex(&name##_front, (uint16_t)(front + 1) & CIRCULARBUFFER_MASK(length_2N)); \
+			return true; \
+		} \
+		return false; \
+	} \
+	static inline uint16_t name##_pushBack(const uint8_t * const data, const uint16_t maxlen) { \
+		const uint16_t back = name##_back; \
+		uint16_t len = CIRCULARBUFFER_MASK(length_2N) - ((uint16_t)(back - CircularBuffer_loadIndex(&name##_front)) & CIRCULARBUFFER_MASK(length_2N)); \
+		if (len > maxlen) { \
+			len = maxlen; \
+		} \
+		const uint32_t partialLen = (1UL << (length_2N)) - back; \
+		if (len <= partialLen) { \
+			CircularBuffer_copy(&name##_memory[back], data, len); \
+		} else { \
+			CircularBuffer_copy(&name##_memory[back], data, partialLen); \
+			CircularBuffer_copy(name##_memory, data + partialLen, len - partialLen); \
+		} \
+		CircularBuffer_storeIndex(&name##_back, (uint16_t)(back + len) & CIRCULARBUFFER_MASK(length_2N)); \
+		return len; \
+	} \
+	static inline uint16_t name##_popFront(uint8_t * const data, const uint16_t maxlen) { \
+		const uint16_t front = name##_front; \
+		uint16_t len = (uint16_t)(CircularBuffer_loadIndex(&name##_back) - front) & CIRCULARBUFFER_MASK(length_2N); \
+		if (len > maxlen) { \
+			len = maxlen; \
+		} \
+		const uint32_t partialLen = (1UL << (length_2N)) - front; \
+		if (len <= partialLen) { \
+			CircularBuffer_copy(data, &name##_memory[front], len); \
+		} else { \
+			CircularBuffer_copy(data, &name##_memory[front], partialLen); \
+			CircularBuffer_copy(data + partialLen, name##_memory, len - partialLen); \
+		} \
+		CircularBuffer_storeIndex(&name##_front, (uint16_t)(front + len) & CIRCULARBUFFER_MASK(length_2N)); \
+		return len; \
+	}
 
 #endif
@@ -0,0 +1,339 @@
+/**
+ * @file      circularbuffer.hpp
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     C++20 wrapper of the circular buffer with coroutine awaitables.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CIRCULARBUFFER_HPP_
+#define _CIRCULARBUFFER_HPP_
+
+// Includes.
+extern "C" {
+#include "circularbuffer.h"
+}
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <compare>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+namespace circus {
+
+/*
+ * @brief Single producer, single consumer ring. A coroutine on either side can co_await read_at_least(n) or
+ *        write_space(n) and is resumed by the push or pop of the other side that makes the condition true. Each
+ *        side has one waiter slot, a wakeup is delivered once per wait. With producer and consumer on different
+ *        threads the library must be built with CIRCULARBUFFER_SMP=1. The waiter is resumed inline by the thread
+ *        that pushed or popped, unless an executor is set.
+ */
+class Ring {
+public:
+	using Executor = void (*)(std::coroutine_handle<> handle, void * context);
+
+	/*
+	 * @brief Initializes the ring on the given memory.
+	 * @param memory The buffer memory.
+	 * @param length Size of the buffer memory in bytes, up to 65536.
+	 */
+	Ring(uint8_t * const memory, const uint32_t length) {
+		CircularBuffer_initWithLength(&bufferObject, memory, length);
+	}
+	Ring(const Ring &) = delete;
+	Ring & operator=(const Ring &) = delete;
+
+	/*
+	 * @brief Sets the executor that resumes the waiters, i.e. to post them to a thread pool.
+	 * @param function The executor, nullptr to resume inline.
+	 * @param context Context passed to the executor.
+	 */
+	void set_executor(const Executor function, void * const context) {
+		executor = function;
+		executorContext = context;
+	}
+
+	// Access to the C object, pushes and pops done on it directly do not wake the waiters.
+	CircularBufferObject_t * native() {
+		return &bufferObject;
+	}
+
+	// Occupancy.
+	uint16_t size() const {
+		return CircularBuffer_getUnreadSize(&bufferObject);
+	}
+	uint16_t free_space() const {
+		return bufferObject.capacity - CircularBuffer_getUnreadSize(&bufferObject);
+	}
+	uint16_t capacity() const {
+		return bufferObject.capacity;
+	}
+
+	/*
+	 * @brief Random-access iterator over the unread data, an offset from the front that wraps on access. Valid on the
+	 *        consumer side until the data is popped.
+	 */
+	class const_iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using iterator_concept = std::random_access_iterator_tag;
+		using value_type = uint8_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const uint8_t *;
+		using reference = const uint8_t &;
+
+		const_iterator() = default;
+		const_iterator(const uint8_t * const memory, const uint32_t length, const uint32_t front, const difference_type offset)
+			: memory(memory), length(length), front(front), offset(offset) {
+		}
+		reference operator*() const {
+			return memory[wrap(front + offset)];
+		}
+		pointer operator->() const {
+			return &**this;
+		}
+		reference operator[](const difference_type n) const {
+			return memory[wrap(front + offset + n)];
+		}
+		const_iterator & operator++() {
+			++offset;
+			return *this;
+		}
+		const_iterator operator++(int) {
+			const_iterator previous = *this;
+			++offset;
+			return previous;
+		}
+		const_iterator & operator--() {
+			--offset;
+			return *this;
+		}
+		const_iterator operator--(int) {
+			const_iterator previous = *this;
+			--offset;
+			return previous;
+		}
+		const_iterator & operator+=(const difference_type n) {
+			offset += n;
+			return *this;
+		}
+		const_iterator & operator-=(const difference_type n) {
+			offset -= n;
+			return *this;
+		}
+		friend const_iterator operator+(const_iterator iterator, const difference_type n) {
+			return iterator += n;
+		}
+		friend const_iterator operator+(const difference_type n, const_iterator iterator) {
+			return iterator += n;
+		}
+		friend const_iterator operator-(const_iterator iterator, const difference_type n) {
+			return iterator -= n;
+		}
+		friend difference_type operator-(const const_iterator & a, const const_iterator & b) {
+			return a.offset - b.offset;
+		}
+		friend bool operator==(const const_iterator & a, const const_iterator & b) {
+			return a.offset == b.offset;
+		}
+		friend std::strong_ordering operator<=>(const const_iterator & a, const const_iterator & b) {
+			return a.offset <=> b.offset;
+		}
+
+	private:
+		// Offsets are within the unread data, so one conditional subtract wraps them.
+		uint32_t wrap(const difference_type position) const {
+			return ((uint32_t)position >= length) ? (uint32_t)position - length : (uint32_t)position;
+		}
+		const uint8_t * memory = nullptr;
+		uint32_t length = 0;
+		uint32_t front = 0;
+		difference_type offset = 0;
+	};
+
+	// Unread data as an iterator range, end() takes a new snapshot of the unread size.
+	const_iterator begin() const {
+		return const_iterator(bufferObject.memory, bufferObject.length, bufferObject.front, 0);
+	}
+	const_iterator end() const {
+		return const_iterator(bufferObject.memory, bufferObject.length, bufferObject.front, size());
+	}
+
+	/*
+	 * @brief Gets the unread data as two contiguous spans, the second is empty unless the data wraps.
+	 * @return The spans in order.
+	 */
+	std::array<std::span<const uint8_t>, 2> segments() const {
+		const uint16_t unread = size();
+		const uint32_t front = bufferObject.front;
+		const uint32_t first = (unread < bufferObject.length - front) ? unread : bufferObject.length - front;
+		return {
+			std::span<const uint8_t>(bufferObject.memory + front, first),
+			std::span<const uint8_t>(bufferObject.memory, unread - first)
+		};
+	}
+
+	// Producer side, wakes a reader waiting for data.
+	bool push_byte(const uint8_t data) {
+		const bool result = CircularBuffer_pushBackByte(&bufferObject, data);
+		if (result) {
+			wake(reader, size());
+		}
+		return result;
+	}
+	uint16_t push(const uint8_t * const data, const uint16_t maxlen) {
+		const uint16_t result = CircularBuffer_pushBack(&bufferObject, data, maxlen);
+		if (result) {
+			wake(reader, size());
+		}
+		return result;
+	}
+	void advance_back(const uint16_t len) {
+		CircularBuffer_advanceBack(&bufferObject, len);
+		wake(reader, size());
+	}
+
+	// Consumer side, wakes a writer waiting for space.
+	bool pop_byte(uint8_t & data) {
+		const bool result = CircularBuffer_popFrontByte(&bufferObject, &data);
+		if (result) {
+			wake(writer, free_space());
+		}
+		return result;
+	}
+	uint16_t pop(uint8_t * const data, const uint16_t maxlen) {
+		const uint16_t result = CircularBuffer_popFront(&bufferObject, data, maxlen);
+		if (result) {
+			wake(writer, free_space());
+		}
+		return result;
+	}
+	void advance_front(const uint16_t len) {
+		CircularBuffer_advanceFront(&bufferObject, len);
+		wake(writer, free_space());
+	}
+
+private:
+	// Waiter slot of one side.
+	struct Waiter {
+		std::atomic<void *> handle{nullptr};
+		std::atomic<uint16_t> needed{0};
+	};
+
+public:
+	// Awaitable of a side, resumes with the unread size for the reader, with the free size for the writer.
+	class Awaiter {
+	public:
+		Awaiter(Ring & ring, Waiter & waiter, const uint16_t needed, const bool reading)
+			: ring(ring), waiter(waiter), needed(needed), reading(reading) {
+		}
+		bool await_ready() const {
+			return available() >= needed;
+		}
+		bool await_suspend(const std::coroutine_handle<> handle) {
+			// Once registered the other side may resume the coroutine and destroy this awaiter, use locals only.
+			Ring & localRing = ring;
+			Waiter & localWaiter = waiter;
+			const uint16_t localNeeded = needed;
+			const bool localReading = reading;
+
+			// Register, then check again, the other side may have moved between await_ready and now.
+			localWaiter.needed.store(localNeeded, std::memory_order_relaxed);
+			localWaiter.handle.store(handle.address(), std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if ((localReading ? localRing.size() : localRing.free_space()) >= localNeeded) {
+				// Take the slot back, if the other side already took it, it resumes us.
+				return localWaiter.handle.exchange(nullptr, std::memory_order_acq_rel) == nullptr;
+			}
+			return true;
+		}
+		uint16_t await_resume() const {
+			return available();
+		}
+
+	private:
+		uint16_t available() const {
+			return reading ? ring.size() : ring.free_space();
+		}
+		Ring & ring;
+		Waiter & waiter;
+		const uint16_t needed;
+		const bool reading;
+	};
+
+	/*
+	 * @brief Waits until at least n bytes are unread.
+	 * @param n Number of bytes, 1 to the capacity.
+	 * @return Awaitable resuming with the unread size.
+	 */
+	Awaiter read_at_least(const uint16_t n) {
+		assert(n && (n <= bufferObject.capacity));
+		return Awaiter(*this, reader, n, true);
+	}
+
+	/*
+	 * @brief Waits until at least n bytes are free.
+	 * @param n Number of bytes, 1 to the capacity.
+	 * @return Awaitable resuming with the free size.
+	 */
+	Awaiter write_space(const uint16_t n) {
+		assert(n && (n <= bufferObject.capacity));
+		return Awaiter(*this, writer, n, false);
+	}
+
+private:
+	/*
+	 * @brief Resumes the waiter of the other side if its condition became true.
+	 * @param waiter The waiter slot.
+	 * @param available The unread or free size after the push or pop.
+	 */
+	void wake(Waiter & waiter, const uint16_t available) {
+		// Order the pointer update before the slot check, pairs with the fence in await_suspend.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiter.handle.load(std::memory_order_acquire) && (available >= waiter.needed.load(std::memory_order_relaxed))) {
+			void * const address = waiter.handle.exchange(nullptr, std::memory_order_acq_rel);
+			if (address) {
+				const std::coroutine_handle<> handle = std::coroutine_handle<>::from_address(address);
+				if (executor) {
+					executor(handle, executorContext);
+				} else {
+					handle.resume();
+				}
+			}
+		}
+	}
+
+	CircularBufferObject_t bufferObject;
+	Waiter reader;
+	Waiter writer;
+	Executor executor = nullptr;
+	void * executorContext = nullptr;
+};
+
+}
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * @file      circularcompress.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     LZ4-style block compression from one circular buffer into another, and back.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include "circularcompress.h"
+#include <string.h>
+#include <assert.h>
+
+#if (CIRCULARCOMPRESS_WINDOW > 65535) || (CIRCULARCOMPRESS_BLOCK > 65535) || (CIRCULARCOMPRESS_BLOCK + CIRCULARCOMPRESS_HEADER_SIZE > 65535)
+#error "CIRCULARCOMPRESS_WINDOW and CIRCULARCOMPRESS_BLOCK must fit the 16-bit offsets and lengths"
+#endif
+
+// Sequences.
+#define CIRCULARCOMPRESS_MINMATCH 4
+#define CIRCULARCOMPRESS_NIBBLE 15
+
+/*
+ * @brief Initializes a compressor or a decompressor with an empty dictionary.
+ * @param state The state.
+ */
+void CircularCompress_init(CircularCompress_t * const state) {
+	// State check.
+	assert(state);
+
+	memset(state->table, 0, sizeof(state->table));
+	state->position = 0;
+	state->historyLen = 0;
+	state->faultFlag = false;
+}
+
+/*
+ * @brief Checks for fault (i.e. a corrupt block) and resets the dictionary on request. After a fault the dictionary
+ *        is out of step with the other side, so both sides reset theirs before the stream continues.
+ * @param state The state.
+ * @param resetDictionary Set true to empty the dictionary, as CircularCompress_init does.
+ * @return Returns true if a fault occured and clears the fault before return.
+ */
+bool CircularCompress_checkAndClearFault(CircularCompress_t * const state, const bool resetDictionary) {
+	// State check.
+	assert(state);
+
+	const bool fault = state->faultFlag;
+	if (resetDictionary) {
+		CircularCompress_init(state);
+	}
+	state->faultFlag = false;
+	return fault;
+}
+
+/*
+ * @brief Keeps the last window of raw data as the dictionary of the next block, the same on both sides.
+ * @param state The state.
+ * @param len Size of the block that was appended after the dictionary.
+ */
+static void CircularCompress_slide(CircularCompress_t * const state, const uint16_t len) {
+	const uint32_t total = (uint32_t)state->historyLen + len;
+	const uint16_t keep = (total < CIRCULARCOMPRESS_WINDOW) ? (uint16_t)total : CIRCULARCOMPRESS_WINDOW;
+	memmove(&state->history[CIRCULARCOMPRESS_WINDOW - keep], &state->history[CIRCULARCOMPRESS_WINDOW + len - keep], keep);
+	state->historyLen = keep;
+	state->position += len;
+}
+
+/*
+ * @brief Reads 4 bytes for hashing and comparing.
+ */
+static inline uint32_t CircularCompress_read32(const uint8_t * const data) {
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+/*
+ * @brief Writes a length extension of 255-valued bytes.
+ * @return Pointer after the extension, NULL if it does not fit.
+ */
+static uint8_t * CircularCompress_writeLength(uint8_t * output, const uint8_t * const end, uint32_t len) {
+	for (; len >= 255; len -= 255) {
+		if (output == end) {
+			return NULL;
+		}
+		*output++ = 255;
+	}
+	if (output == end) {
+		return NULL;
+	}
+	*output++ = (uint8_t)len;
+	return output;
+}
+
+/*
+ * @brief Writes a sequence of literals followed by a match, or only literals at the end of the block.
+ * @return Pointer after the sequence, NULL if it does not fit.
+ */
+static uint8_t * CircularCompress_writeSequence(uint8_t * output, const uint8_t * const end, const uint8_t * const literals, const uint32_t literalLen, const uint16_t offset, const uint32_t matchLen) {
+	const uint32_t matchCode = offset ? matchLen - CIRCULARCOMPRESS_MINMATCH : 0;
+
+	// Token, both nibbles saturate into extensions.
+	if (output == end) {
+		return NULL;
+	}
+	*output++ = (uint8_t)(((literalLen < CIRCULARCOMPRESS_NIBBLE) ? literalLen : CIRCULARCOMPRESS_NIBBLE) << 4
+		| ((matchCode < CIRCULARCOMPRESS_NIBBLE) ? matchCode : CIRCULARCOMPRESS_NIBBLE));
+	if ((literalLen >= CIRCULARCOMPRESS_NIBBLE) && !(output = CircularCompress_writeLength(output, end, literalLen - CIRCULARCOMPRESS_NIBBLE))) {
+		return NULL;
+	}
+
+	// Literals.
+	if (literalLen > (uint32_t)(end - output)) {
+		return NULL;
+	}
+	memcpy(output, literals, literalLen);
+	output += literalLen;
+
+	// Match offset and length.
+	if (offset) {
+		if (end - output < 2) {
+			return NULL;
+		}
+		*output++ = (uint8_t)offset;
+		*output++ = (uint8_t)(offset >> 8);
+		if ((matchCode >= CIRCULARCOMPRESS_NIBBLE) && !(output = CircularCompress_writeLength(output, end, matchCode - CIRCULARCOMPRESS_NIBBLE))) {
+			return NULL;
+		}
+	}
+	return output;
+}
+
+/*
+ * @brief Compresses the block after the dictionary with greedy hash-chained matches.
+ * @param state The state.
+ * @param len Size of the block.
+ * @param output The output memory.
+ * @param outputLen Size of the output memory, less than len so that compression pays off.
+ * @return Size of the compressed block, 0 if it does not fit in the output memory.
+ */
+static uint16_t CircularCompress_encodeBlock(CircularCompress_t * const state, const uint16_t len, uint8_t * const output, const uint16_t outputLen) {
+	const uint8_t * const history = state->history;
+	const uint8_t * const outputEnd = output + outputLen;
+	const uint32_t start = CIRCULARCOMPRESS_WINDOW, end = CIRCULARCOMPRESS_WINDOW + len;
+	const uint32_t oldest = CIRCULARCOMPRESS_WINDOW - state->historyLen;
+	uint32_t index = start, anchor = start;
+	uint8_t * current = output;
+
+	while (index + CIRCULARCOMPRESS_MINMATCH <= end) {
+		// Look up and replace the last position of these 4 bytes, positions are absolute in the stream.
+		const uint32_t sequence = CircularCompress_read32(&history[index]);
+		const uint32_t hash = (uint32_t)(sequence * 2654435761UL) >> (32 - CIRCULARCOMPRESS_HASH_BITS);
+		const uint32_t candidate = state->table[hash] + CIRCULARCOMPRESS_WINDOW - state->position;
+		state->table[hash] = state->position + index - CIRCULARCOMPRESS_WINDOW;
+
+		// Skip faster through data that does not match.
+		if ((candidate < oldest) || (candidate >= index) || (index - candidate > CIRCULARCOMPRESS_WINDOW)
+			|| (CircularCompress_read32(&history[candidate]) != sequence)) {
+			index += 1 + ((index - anchor) >> 6);
+			continue;
+		}
+
+		// Extend the match, it may run into the bytes it copies.
+		uint32_t matchLen = CIRCULARCOMPRESS_MINMATCH;
+		while ((index + matchLen < end) && (history[candidate + matchLen] == history[index + matchLen])) {
+			matchLen++;
+		}
+		current = CircularCompress_writeSequence(current, outputEnd, &history[anchor], index - anchor, (uint16_t)(index - candidate), matchLen);
+		if (!current) {
+			return 0;
+		}
+		index += matchLen;
+		anchor = index;
+	}
+
+	// Last literals.
+	current = CircularCompress_writeSequence(current, outputEnd, &history[anchor], end - anchor, 0, 0);
+	return current ? (uint16_t)(current - output) : 0;
+}
+
+/*
+ * @brief Compresses the unread data of the input buffer, up to one block, into one block of the output buffer:
+ *        raw size and compressed size (2 bytes each), then the sequences. A block that does not compress is stored
+ *        raw with both sizes equal. Matches reach back into the previous blocks up to the window size. The block
+ *        is written in place when the free span of the output is contiguous, otherwise through the scratch memory.
+ * @param state The compressor state.
+ * @param input The input buffer, i.e. the rx buffer.
+ * @param output The output buffer, i.e. the uplink buffer.
+ * @return Raw bytes consumed from the input, 0 if there is no data or not enough space for the output.
+ */
+uint16_t CircularCompress_compress(CircularCompress_t * const state, CircularBufferObject_t * const input, CircularBufferObject_t * const output) {
+	// State check.
+	assert(state && input && output);
+
+	// Raw size, limited so that even a stored block fits.
+	const uint16_t freeSize = output->capacity - CircularBuffer_getUnreadSize(output);
+	if (freeSize <= CIRCULARCOMPRESS_HEADER_SIZE) {
+		return 0;
+	}
+	uint16_t len = CircularBuffer_getUnreadSize(input);
+	if (len > CIRCULARCOMPRESS_BLOCK) {
+		len = CIRCULARCOMPRESS_BLOCK;
+	}
+	if (len > freeSize - CIRCULARCOMPRESS_HEADER_SIZE) {
+		len = freeSize - CIRCULARCOMPRESS_HEADER_SIZE;
+	}
+	if (!len) {
+		return 0;
+	}
+
+	// Append the block to the dictionary.
+	CircularBuffer_peek(input, 0, &state->history[CIRCULARCOMPRESS_WINDOW], len);
+
+	// Compress in place if the span is contiguous.
+	uint8_t * block;
+	const bool inPlace = CircularBuffer_getBackSpan(output, &block) >= (uint16_t)(CIRCULARCOMPRESS_HEADER_SIZE + len);
+	if (!inPlace) {
+		block = state->scratch;
+	}
+	uint16_t compressedLen = CircularCompress_encodeBlock(state, len, &block[CIRCULARCOMPRESS_HEADER_SIZE], len - 1);
+	if (!compressedLen) {
+		memcpy(&block[CIRCULARCOMPRESS_HEADER_SIZE], &state->history[CIRCULARCOMPRESS_WINDOW], len);
+		compressedLen = len;
+	}
+	block[0] = (uint8_t)len;
+	block[1] = (uint8_t)(len >> 8);
+	block[2] = (uint8_t)compressedLen;
+	block[3] = (uint8_t)(compressedLen >> 8);
+
+	// Publish the block and consume the input.
+	if (inPlace) {
+		CircularBuffer_advanceBack(output, CIRCULARCOMPRESS_HEADER_SIZE + compressedLen);
+	} else {
+		CircularBuffer_pushBack(output, block, CIRCULARCOMPRESS_HEADER_SIZE + compressedLen);
+	}
+	CircularBuffer_skip(input, len);
+	CircularCompress_slide(state, len);
+	return len;
+}
+
+/*
+ * @brief Reads a length extension.
+ * @return Returns false if the block ends within the extension.
+ */
+static bool CircularCompress_readLength(const uint8_t ** const input, const uint8_t * const end, uint32_t * const len) {
+	uint8_t data;
+	do {
+		if (*input == end) {
+			return false;
+		}
+		data = *(*input)++;
+		*len += data;
+	} while (data == 255);
+	return true;
+}
+
+/*
+ * @brief Decompresses a block after the dictionary, checking every length and offset.
+ * @param state The state.
+ * @param input The compressed block.
+ * @param inputLen Size of the compressed block.
+ * @param len Raw size of the block.
+ * @return Returns true on success, false if the block is corrupt.
+ */
+static bool CircularCompress_decodeBlock(CircularCompress_t * const state, const uint8_t * input, const uint16_t inputLen, const uint16_t len) {
+	const uint8_t * const inputEnd = input + inputLen;
+	const uint32_t oldest = CIRCULARCOMPRESS_WINDOW - state->historyLen, end = CIRCULARCOMPRESS_WINDOW + len;
+	uint8_t * const history = state->history;
+	uint32_t index = CIRCULARCOMPRESS_WINDOW;
+
+	while (input < inputEnd) {
+		// Literals.
+		const uint8_t token = *input++;
+		uint32_t literalLen = token >> 4;
+		if ((literalLen == CIRCULARCOMPRESS_NIBBLE) && !CircularCompress_readLength(&input, inputEnd, &literalLen)) {
+			return false;
+		}
+		if ((literalLen > (uint32_t)(inputEnd - input)) || (literalLen > end - index)) {
+			return false;
+		}
+		memcpy(&history[index], input, literalLen);
+		input += literalLen;
+		index += literalLen;
+
+		// The last sequence has no match.
+		if (input == inputEnd) {
+			break;
+		}
+
+		// Match.
+		if (inputEnd - input < 2) {
+			return false;
+		}
+		const uint32_t offset = input[0] | ((uint32_t)input[1] << 8);
+		input += 2;
+		uint32_t matchLen = token & CIRCULARCOMPRESS_NIBBLE;
+		if ((matchLen == CIRCULARCOMPRESS_NIBBLE) && !CircularCompress_readLength(&input, inputEnd, &matchLen)) {
+			return false;
+		}
+		matchLen += CIRCULARCOMPRESS_MINMATCH;
+		if (!offset || (offset > index - oldest) || (matchLen > end - index)) {
+			return false;
+		}
+
+		// Byte by byte when the match overlaps the bytes it copies.
+		if (offset >= matchLen) {
+			memcpy(&history[index], &history[index - offset], matchLen);
+		} else {
+			for (uint32_t i = 0; i < matchLen; i++) {
+				history[index + i] = history[index - offset + i];
+			}
+		}
+		index += matchLen;
+	}
+	return index == end;
+}
+
+/*
+ * @brief Decompresses the next whole block of the input buffer into the output buffer. The block is decoded in
+ *        place if it is contiguous in the input buffer, otherwise through the scratch memory. A corrupt block is
+ *        dropped and sets the fault flag, the dictionary is out of step after that, so both sides must be
+ *        initialized again.
+ * @param state The decompressor state.
+ * @param input The input buffer, i.e. the downlink buffer.
+ * @param output The output buffer.
+ * @return Raw bytes produced, 0 if there is no whole block or not enough space for it.
+ */
+uint16_t CircularCompress_decompress(CircularCompress_t * const state, CircularBufferObject_t * const input, CircularBufferObject_t * const output) {
+	uint8_t header[CIRCULARCOMPRESS_HEADER_SIZE];
+
+	// State check.
+	assert(state && input && output);
+
+	// Whole block and space for it.
+	if (CircularBuffer_peek(input, 0, header, CIRCULARCOMPRESS_HEADER_SIZE) < CIRCULARCOMPRESS_HEADER_SIZE) {
+		return 0;
+	}
+	const uint16_t len = header[0] | ((uint16_t)header[1] << 8);
+	const uint16_t compressedLen = header[2] | ((uint16_t)header[3] << 8);
+	if ((len > CIRCULARCOMPRESS_BLOCK) || (compressedLen > len)) {
+		CircularBuffer_skip(input, CircularBuffer_getUnreadSize(input));
+		state->faultFlag = true;
+		return 0;
+	}
+	if ((CircularBuffer_getUnreadSize(input) < CIRCULARCOMPRESS_HEADER_SIZE + compressedLen)
+		|| ((uint16_t)(output->capacity - CircularBuffer_getUnreadSize(output)) < len)) {
+		return 0;
+	}
+
+	// Compressed data, in place if contiguous.
+	const uint8_t * block;
+	if (CircularBuffer_getFrontSpan(input, &block) >= (uint16_t)(CIRCULARCOMPRESS_HEADER_SIZE + compressedLen)) {
+		block += CIRCULARCOMPRESS_HEADER_SIZE;
+	} else {
+		CircularBuffer_peek(input, CIRCULARCOMPRESS_HEADER_SIZE, state->scratch, compressedLen);
+		block = state->scratch;
+	}
+
+	// Stored or compressed.
+	bool valid = true;
+	if (compressedLen == len) {
+		memcpy(&state->history[CIRCULARCOMPRESS_WINDOW], block, len);
+	} else {
+		valid = CircularCompress_decodeBlock(state, block, compressedLen, len);
+	}
+	CircularBuffer_skip(input, CIRCULARCOMPRESS_HEADER_SIZE + compressedLen);
+	if (!valid) {
+		state->faultFlag = true;
+		return 0;
+	}
+
+	// Publish and keep the dictionary in step with the compressor.
+	CircularBuffer_pushBack(output, &state->history[CIRCULARCOMPRESS_WINDOW], len);
+	CircularCompress_slide(state, len);
+	return len;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file      circularcompress.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     LZ4-style block compression from one circular buffer into another, and back.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CIRCULARCOMPRESS_H_
+#define _CIRCULARCOMPRESS_H_
+
+// Includes.
+#include "circularbuffer.h"
+
+// Settings, both sides must use the same window.
+#ifndef CIRCULARCOMPRESS_WINDOW
+#define CIRCULARCOMPRESS_WINDOW 4096
+#endif
+#ifndef CIRCULARCOMPRESS_BLOCK
+#define CIRCULARCOMPRESS_BLOCK 4096
+#endif
+#ifndef CIRCULARCOMPRESS_HASH_BITS
+#define CIRCULARCOMPRESS_HASH_BITS 12
+#endif
+#define CIRCULARCOMPRESS_HEADER_SIZE 4
+
+// Type definitions.
+typedef struct{
+	uint8_t history[CIRCULARCOMPRESS_WINDOW + CIRCULARCOMPRESS_BLOCK];
+	uint8_t scratch[CIRCULARCOMPRESS_HEADER_SIZE + CIRCULARCOMPRESS_BLOCK];
+	uint32_t table[1UL << CIRCULARCOMPRESS_HASH_BITS];
+	uint32_t position;
+	uint16_t historyLen;
+	bool faultFlag;
+}CircularCompress_t;
+
+// Prototypes.
+void CircularCompress_init(CircularCompress_t * const state);
+bool CircularCompress_checkAndClearFault(CircularCompress_t * const state, const bool resetDictionary);
+uint16_t CircularCompress_compress(CircularCompress_t * const state, CircularBufferObject_t * const input, CircularBufferObject_t * const output);
+uint16_t CircularCompress_decompress(CircularCompress_t * const state, CircularBufferObject_t * const input, CircularBufferObject_t * const output);
+
+#endif
@@ -0,0 +1,440 @@
+/**
+ * @file      circularframe.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     COBS, SLIP and HDLC framing directly on the circular buffer memory.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include "circularframe.h"
+#include <string.h>
+#include <assert.h>
+
+// Special bytes.
+#define CIRCULARFRAME_COBS_DELIMITER 0x00
+#define CIRCULARFRAME_COBS_MAXRUN 254
+#define CIRCULARFRAME_SLIP_END 0xC0
+#define CIRCULARFRAME_SLIP_ESC 0xDB
+#define CIRCULARFRAME_SLIP_ESC_END 0xDC
+#define CIRCULARFRAME_SLIP_ESC_ESC 0xDD
+#define CIRCULARFRAME_HDLC_FLAG 0x7E
+#define CIRCULARFRAME_HDLC_ESC 0x7D
+#define CIRCULARFRAME_HDLC_XOR 0x20
+#define CIRCULARFRAME_HDLC_FCS_INIT 0xFFFF
+#define CIRCULARFRAME_HDLC_FCS_GOOD 0xF0B8
+
+// Type definitions.
+typedef size_t CircularFrameWord_t;
+typedef struct{
+	CircularBufferObject_t * bufferObject;
+	uint16_t position;
+	uint16_t free;
+	uint16_t len;
+}CircularFrameWriter_t;
+
+// Variables.
+static const uint16_t CircularFrame_fcsTable[16] = {
+	0x0000, 0x1081, 0x2102, 0x3183, 0x4204, 0x5285, 0x6306, 0x7387,
+	0x8408, 0x9489, 0xA50A, 0xB58B, 0xC60C, 0xD68D, 0xE70E, 0xF78F
+};
+
+/*
+ * @brief Updates the HDLC frame check sequence (CRC-16/X.25, RFC 1662) with a nibble table.
+ * @param fcs The running frame check sequence.
+ * @param data Pointer to the data.
+ * @param len Size of the data.
+ * @return The updated frame check sequence.
+ */
+static uint16_t CircularFrame_fcs(uint16_t fcs, const uint8_t * data, uint16_t len) {
+	while (len--) {
+		fcs = (fcs >> 4) ^ CircularFrame_fcsTable[(fcs ^ *data) & 0x0F];
+		fcs = (fcs >> 4) ^ CircularFrame_fcsTable[(fcs ^ (*data >> 4)) & 0x0F];
+		data++;
+	}
+	return fcs;
+}
+
+/*
+ * @brief Finds the first of two special bytes, a word at a time.
+ * @param data Pointer to the data.
+ * @param len Size of the data.
+ * @param a First special byte.
+ * @param b Second special byte.
+ * @return Index of the first special byte, len if there is none.
+ */
+static uint16_t CircularFrame_findSpecial(const uint8_t * const data, const uint16_t len, const uint8_t a, const uint8_t b) {
+	const CircularFrameWord_t ones = (CircularFrameWord_t)-1 / 0xFF;
+	const CircularFrameWord_t highs = ones * 0x80;
+	uint16_t i = 0;
+
+	// A word has a zero byte if (w - ones) & ~w has its high bit set, so compare all bytes by xor at once.
+	for (; (uint32_t)i + sizeof(CircularFrameWord_t) <= len; i += sizeof(CircularFrameWord_t)) {
+		CircularFrameWord_t word, xa, xb;
+		memcpy(&word, &data[i], sizeof(word));
+		xa = word ^ (ones * a);
+		xb = word ^ (ones * b);
+		if (((xa - ones) & ~xa & highs) | ((xb - ones) & ~xb & highs)) {
+			break;
+		}
+	}
+
+	// Locate the byte in the word that matched, or check the tail.
+	for (; i < len; i++) {
+		if ((data[i] == a) || (data[i] == b)) {
+			break;
+		}
+	}
+	return i;
+}
+
+/*
+ * @brief Writes data into the free space after the back pointer without publishing it.
+ * @param writer The writer.
+ * @param data Pointer to the data source.
+ * @param len Size of the data.
+ * @return Returns true on success, false if the free space is exhausted.
+ */
+static bool CircularFrame_write(CircularFrameWriter_t * const writer, const uint8_t * const data, const uint16_t len) {
+	CircularBufferObject_t * const bufferObject = writer->bufferObject;
+
+	// Space check.
+	if (len > writer->free) {
+		return false;
+	}
+
+	// Copy in 1 or 2 parts.
+	uint16_t partialLen = len;
+	if ((bufferObject->length - writer->position) < partialLen) {
+		partialLen = bufferObject->length - writer->position;
+	}
+	CircularBuffer_copy(&bufferObject->memory[writer->position], data, partialLen);
+	if (partialLen < len) {
+		CircularBuffer_copy(bufferObject->memory, data + partialLen, len - partialLen);
+	}
+
+	// Advance the local position.
+	uint32_t position = (uint32_t)writer->position + len;
+	if (position >= bufferObject->length) {
+		position -= bufferObject->length;
+	}
+	writer->position = (uint16_t)position;
+	writer->free -= len;
+	writer->len += len;
+	return true;
+}
+
+/*
+ * @brief Writes a byte into the free space after the back pointer without publishing it.
+ * @param writer The writer.
+ * @param data The byte.
+ * @return Returns true on success, false if the free space is exhausted.
+ */
+static bool CircularFrame_writeByte(CircularFrameWriter_t * const writer, const uint8_t data) {
+	// Space check.
+	if (!writer->free) {
+		return false;
+	}
+
+	// Write and advance the local position.
+	writer->bufferObject->memory[writer->position] = data;
+	if (++writer->position == writer->bufferObject->length) {
+		writer->position = 0;
+	}
+	writer->free--;
+	writer->len++;
+	return true;
+}
+
+/*
+ * @brief Writes data with the special bytes escaped, runs of plain bytes are copied at once.
+ * @param writer The writer.
+ * @param codec CircularFrame_SLIP or CircularFrame_HDLC.
+ * @param data Pointer to the data source.
+ * @param len Size of the data.
+ * @return Returns true on success, false if the free space is exhausted.
+ */
+static bool CircularFrame_writeEscaped(CircularFrameWriter_t * const writer, const CircularFrameCodec_t codec, const uint8_t * data, uint16_t len) {
+	const uint8_t end = (codec == CircularFrame_SLIP) ? CIRCULARFRAME_SLIP_END : CIRCULARFRAME_HDLC_FLAG;
+	const uint8_t esc = (codec == CircularFrame_SLIP) ? CIRCULARFRAME_SLIP_ESC : CIRCULARFRAME_HDLC_ESC;
+
+	while (len) {
+		// Copy the plain run.
+		const uint16_t run = CircularFrame_findSpecial(data, len, end, esc);
+		if (!CircularFrame_write(writer, data, run)) {
+			return false;
+		}
+		data += run;
+		len -= run;
+
+		// Escape the special byte.
+		if (len) {
+			uint8_t escaped;
+			if (codec == CircularFrame_SLIP) {
+				escaped = (*data == end) ? CIRCULARFRAME_SLIP_ESC_END : CIRCULARFRAME_SLIP_ESC_ESC;
+			} else {
+				escaped = *data ^ CIRCULARFRAME_HDLC_XOR;
+			}
+			if (!CircularFrame_writeByte(writer, esc) || !CircularFrame_writeByte(writer, escaped)) {
+				return false;
+			}
+			data++;
+			len--;
+		}
+	}
+	return true;
+}
+
+/*
+ * @brief Encodes a frame into the free space of the buffer and publishes it at once. COBS frames end with a zero,
+ *        SLIP and HDLC frames start and end with the delimiter, HDLC frames carry a 16-bit FCS.
+ * @param bufferObject The buffer object handler, i.e. the tx buffer.
+ * @param codec The framing.
+ * @param data Pointer to the payload.
+ * @param len Size of the payload.
+ * @return Size of the encoded frame, 0 if it does not fit and nothing was pushed.
+ */
+uint16_t CircularFrame_encode(CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec, const uint8_t * const data, const uint16_t len) {
+	// Buffer check.
+	assert(bufferObject && bufferObject->memory && (data || !len));
+
+	// Write after the back pointer, nothing is visible to the reader until published.
+	CircularFrameWriter_t writer = {bufferObject, bufferObject->back, (uint16_t)(bufferObject->capacity - CircularBuffer_getUnreadSize(bufferObject)), 0};
+	bool success = true;
+
+	// COBS, each block is a code byte and up to 254 non-zero bytes, the code is the offset to the next zero.
+	if (codec == CircularFrame_COBS) {
+		uint16_t position = 0;
+		while (success) {
+			const uint16_t limit = (len - position < CIRCULARFRAME_COBS_MAXRUN) ? len - position : CIRCULARFRAME_COBS_MAXRUN;
+			const uint8_t * const zero = limit ? memchr(&data[position], CIRCULARFRAME_COBS_DELIMITER, limit) : NULL;
+			const uint16_t run = zero ? (uint16_t)(zero - &data[position]) : limit;
+			success = CircularFrame_writeByte(&writer, (uint8_t)(run + 1)) && CircularFrame_write(&writer, &data[position], run);
+			position += run;
+
+			// A zero is implied by the code, a full block has none.
+			if (zero) {
+				position++;
+			} else if ((run < CIRCULARFRAME_COBS_MAXRUN) || (position == len)) {
+				break;
+			}
+		}
+		success = success && CircularFrame_writeByte(&writer, CIRCULARFRAME_COBS_DELIMITER);
+	}
+
+	// SLIP, the leading delimiter flushes line noise at the receiver.
+	else if (codec == CircularFrame_SLIP) {
+		success = CircularFrame_writeByte(&writer, CIRCULARFRAME_SLIP_END)
+			&& CircularFrame_writeEscaped(&writer, codec, data, len)
+			&& CircularFrame_writeByte(&writer, CIRCULARFRAME_SLIP_END);
+	}
+
+	// HDLC, asynchronous framing of RFC 1662 with the complemented FCS sent least significant byte first.
+	else {
+		const uint16_t fcs = CircularFrame_fcs(CIRCULARFRAME_HDLC_FCS_INIT, data, len) ^ 0xFFFF;
+		const uint8_t fcsBytes[2] = {(uint8_t)fcs, (uint8_t)(fcs >> 8)};
+		success = CircularFrame_writeByte(&writer, CIRCULARFRAME_HDLC_FLAG)
+			&& CircularFrame_writeEscaped(&writer, codec, data, len)
+			&& CircularFrame_writeEscaped(&writer, codec, fcsBytes, 2)
+			&& CircularFrame_writeByte(&writer, CIRCULARFRAME_HDLC_FLAG);
+	}
+
+	// Publish the whole frame, or drop it.
+	if (!success) {
+		return 0;
+	}
+	CircularBuffer_advanceBack(bufferObject, writer.len);
+	return writer.len;
+}
+
+/*
+ * @brief Initializes a decoder.
+ * @param decoder The decoder.
+ * @param bufferObject The buffer object handler, i.e. the rx buffer.
+ * @param codec The framing.
+ */
+void CircularFrame_initDecoder(CircularFrameDecoder_t * const decoder, CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec) {
+	// Buffer check.
+	assert(decoder && bufferObject);
+
+	decoder->bufferObject = bufferObject;
+	decoder->codec = codec;
+	decoder->scanned = 0;
+	decoder->discardedFrames = 0;
+}
+
+/*
+ * @brief Finds a byte in the unread data, in 1 or 2 spans by memchr.
+ * @param bufferObject The buffer object handler.
+ * @param from Start offset from the front.
+ * @param to End offset from the front.
+ * @param data The byte to find.
+ * @return Offset of the byte from the front, to if it was not found.
+ */
+static uint16_t CircularFrame_find(const CircularBufferObject_t * const bufferObject, const uint16_t from, const uint16_t to, const uint8_t data) {
+	// Start of the first span.
+	uint32_t position = (uint32_t)bufferObject->front + from;
+	if (position >= bufferObject->length) {
+		position -= bufferObject->length;
+	}
+
+	// Scan up to the end of the memory, then from the start.
+	uint16_t partialLen = to - from;
+	if ((bufferObject->length - position) < partialLen) {
+		partialLen = (uint16_t)(bufferObject->length - position);
+	}
+	const uint8_t * found = memchr(&bufferObject->memory[position], data, partialLen);
+	if (found) {
+		return from + (uint16_t)(found - &bufferObject->memory[position]);
+	}
+	found = memchr(bufferObject->memory, data, (uint16_t)(to - from - partialLen));
+	if (found) {
+		return from + partialLen + (uint16_t)(found - bufferObject->memory);
+	}
+	return to;
+}
+
+/*
+ * @brief Decodes the frame at the front of the buffer.
+ * @param bufferObject The buffer object handler.
+ * @param codec The framing.
+ * @param frameLen Size of the frame up to the delimiter.
+ * @param data Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @return Size of the decoded data, -1 if the frame is invalid or does not fit.
+ */
+static int32_t CircularFrame_decodeFrame(const CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec, const uint16_t frameLen, uint8_t * const data, const uint16_t maxlen) {
+	uint16_t offset = 0, len = 0;
+
+	// COBS, copy each block and restore the implied zero.
+	if (codec == CircularFrame_COBS) {
+		while (offset < frameLen) {
+			uint8_t code;
+			CircularBuffer_peekAt(bufferObject, offset++, &code);
+			const uint16_t run = code - 1;
+			if ((run > frameLen - offset) || (run > maxlen - len)) {
+				return -1;
+			}
+			CircularBuffer_peek(bufferObject, offset, &data[len], run);
+			offset += run;
+			len += run;
+			if ((code <= CIRCULARFRAME_COBS_MAXRUN) && (offset < frameLen)) {
+				if (len == maxlen) {
+					return -1;
+				}
+				data[len++] = 0;
+			}
+		}
+		return len;
+	}
+
+	// SLIP and HDLC, copy the plain runs and unescape.
+	const uint8_t esc = (codec == CircularFrame_SLIP) ? CIRCULARFRAME_SLIP_ESC : CIRCULARFRAME_HDLC_ESC;
+	while (offset < frameLen) {
+		const uint16_t escape = CircularFrame_find(bufferObject, offset, frameLen, esc);
+		const uint16_t run = escape - offset;
+		if (run > maxlen - len) {
+			return -1;
+		}
+		CircularBuffer_peek(bufferObject, offset, &data[len], run);
+		len += run;
+		offset = escape;
+
+		// Unescape the next byte.
+		if (offset < frameLen) {
+			uint8_t escaped;
+			if ((offset + 1 == frameLen) || (len == maxlen)) {
+				return -1;
+			}
+			CircularBuffer_peekAt(bufferObject, offset + 1, &escaped);
+			if (codec == CircularFrame_HDLC) {
+				data[len++] = escaped ^ CIRCULARFRAME_HDLC_XOR;
+			} else if (escaped == CIRCULARFRAME_SLIP_ESC_END) {
+				data[len++] = CIRCULARFRAME_SLIP_END;
+			} else if (escaped == CIRCULARFRAME_SLIP_ESC_ESC) {
+				data[len++] = CIRCULARFRAME_SLIP_ESC;
+			} else {
+				return -1;
+			}
+			offset += 2;
+		}
+	}
+
+	// HDLC, check the FCS and strip it.
+	if (codec == CircularFrame_HDLC) {
+		if ((len < 2) || (CircularFrame_fcs(CIRCULARFRAME_HDLC_FCS_INIT, data, len) != CIRCULARFRAME_HDLC_FCS_GOOD)) {
+			return -1;
+		}
+		len -= 2;
+	}
+	return len;
+}
+
+/*
+ * @brief Decodes the next complete frame from the buffer. Empty frames between delimiters are skipped, invalid
+ *        frames and frames longer than maxlen are discarded and counted. The unread data is scanned once, data
+ *        without a delimiter is not scanned again on the next call. If the buffer fills up without a delimiter
+ *        the data is discarded, so the decoder cannot stall.
+ * @param decoder The decoder.
+ * @param data Pointer to the output memory. For HDLC it must have room for the 2-byte FCS after the payload.
+ * @param maxlen Size of the output memory.
+ * @param len Pointer to write the size of the decoded payload.
+ * @return Returns true if a frame was decoded, false if no complete frame is available.
+ */
+bool CircularFrame_decode(CircularFrameDecoder_t * const decoder, uint8_t * const data, const uint16_t maxlen, uint16_t * const len) {
+	// Decoder check.
+	assert(decoder && decoder->bufferObject && (data || !maxlen) && len);
+	CircularBufferObject_t * const bufferObject = decoder->bufferObject;
+	const uint8_t delimiter = (decoder->codec == CircularFrame_COBS) ? CIRCULARFRAME_COBS_DELIMITER
+		: ((decoder->codec == CircularFrame_SLIP) ? CIRCULARFRAME_SLIP_END : CIRCULARFRAME_HDLC_FLAG);
+
+	for (;;) {
+		// Find the delimiter in the data not scanned yet.
+		const uint16_t unread = CircularBuffer_getUnreadSize(bufferObject);
+		if (decoder->scanned > unread) {
+			decoder->scanned = 0;
+		}
+		const uint16_t frameLen = CircularFrame_find(bufferObject, decoder->scanned, unread, delimiter);
+		if (frameLen == unread) {
+			decoder->scanned = unread;
+
+			// Full buffer without a delimiter.
+			if (unread && (unread == bufferObject->capacity)) {
+				CircularBuffer_skip(bufferObject, unread);
+				decoder->scanned = 0;
+				decoder->discardedFrames++;
+			}
+			return false;
+		}
+
+		// Decode, then consume the frame and its delimiter.
+		const int32_t result = frameLen ? CircularFrame_decodeFrame(bufferObject, decoder->codec, frameLen, data, maxlen) : 0;
+		CircularBuffer_skip(bufferObject, frameLen + 1);
+		decoder->scanned = 0;
+		if (result < 0) {
+			decoder->discardedFrames++;
+		} else if (frameLen) {
+			*len = (uint16_t)result;
+			return true;
+		}
+	}
+}
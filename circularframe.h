@@ -0,0 +1,53 @@
+/**
+ * @file      circularframe.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     COBS, SLIP and HDLC framing directly on the circular buffer memory.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CIRCULARFRAME_H_
+#define _CIRCULARFRAME_H_
+
+// Includes.
+#include "circularbuffer.h"
+
+// Type definitions.
+typedef enum{
+	CircularFrame_COBS = 0,
+	CircularFrame_SLIP,
+	CircularFrame_HDLC
+}CircularFrameCodec_t;
+typedef struct{
+	CircularBufferObject_t * bufferObject;
+	CircularFrameCodec_t codec;
+	uint16_t scanned;
+	uint32_t discardedFrames;
+}CircularFrameDecoder_t;
+
+// Prototypes.
+uint16_t CircularFrame_encode(CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec, const uint8_t * const data, const uint16_t len);
+void CircularFrame_initDecoder(CircularFrameDecoder_t * const decoder, CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec);
+bool CircularFrame_decode(CircularFrameDecoder_t * const decoder, uint8_t * const data, const uint16_t maxlen, uint16_t * const len);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file      circularpool.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Fixed-block pool allocator with a circular buffer of free block indices.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include "circularpool.h"
+#include <string.h>
+#include <assert.h>
+
+/*
+ * @brief Initializes the pool with all blocks free. The free list is a circular buffer of 2-byte block indices,
+ *        popped by the side that allocates and pushed by the side that frees. One thread may allocate while
+ *        another frees, i.e. the producer and the consumer of a message buffer, without locking.
+ * @param pool The pool.
+ * @param blocks Memory of the blocks, blockSize * count bytes.
+ * @param blockSize Size of a block in bytes, a multiple of the alignment the payloads need.
+ * @param count Number of blocks, 1 to 32767.
+ * @param freeListMemory Memory of the free list, CIRCULARPOOL_FREELIST_LENGTH(count) bytes.
+ */
+void CircularPool_init(CircularPool_t * const pool, uint8_t * const blocks, const uint32_t blockSize, const uint16_t count, uint8_t * const freeListMemory) {
+	// Pool check.
+	assert(pool && blocks && blockSize && freeListMemory && count && (CIRCULARPOOL_FREELIST_LENGTH(count) <= 0x10000UL));
+
+	pool->blocks = blocks;
+	pool->blockSize = blockSize;
+	pool->count = count;
+
+	// Exactly room for every index, so a free never fails.
+	CircularBuffer_initWithLength(&pool->freeList, freeListMemory, CIRCULARPOOL_FREELIST_LENGTH(count));
+	for (uint16_t index = 0; index < count; index++) {
+		CircularBuffer_pushBack(&pool->freeList, (const uint8_t *)&index, sizeof(index));
+	}
+}
+
+/*
+ * @brief Allocates a block in constant time.
+ * @param pool The pool.
+ * @return Pointer to the block, NULL if all blocks are in use.
+ */
+void * CircularPool_alloc(CircularPool_t * const pool) {
+	uint16_t index;
+
+	// Pool check.
+	assert(pool);
+
+	// An index is published as a whole, so either both bytes are there or none.
+	if (CircularBuffer_popFront(&pool->freeList, (uint8_t *)&index, sizeof(index)) != sizeof(index)) {
+		return NULL;
+	}
+	return pool->blocks + (uint32_t)index * pool->blockSize;
+}
+
+/*
+ * @brief Returns a block to the pool in constant time. A block must be freed once per allocation.
+ * @param pool The pool.
+ * @param block Pointer to the block, as returned by CircularPool_alloc.
+ */
+void CircularPool_free(CircularPool_t * const pool, void * const block) {
+	// Pool check.
+	assert(pool && block);
+
+	const uint16_t index = CircularPool_indexOf(pool, block);
+	const uint16_t pushed = CircularBuffer_pushBack(&pool->freeList, (const uint8_t *)&index, sizeof(index));
+
+	// The free list has room for every block index, so the push cannot fail. Double frees are not detected.
+	assert(pushed == sizeof(index));
+	(void)pushed;
+}
+
+/*
+ * @brief Gets the number of free blocks.
+ * @param pool The pool.
+ * @return Number of free blocks.
+ */
+uint16_t CircularPool_getFreeCount(const CircularPool_t * const pool) {
+	// Pool check.
+	assert(pool);
+
+	return CircularBuffer_getUnreadSize(&pool->freeList) / 2;
+}
+
+/*
+ * @brief Gets the index of a block, i.e. to pass it through a circular buffer in 2 bytes instead of a pointer.
+ * @param pool The pool.
+ * @param block Pointer to the block.
+ * @return Index of the block.
+ */
+uint16_t CircularPool_indexOf(const CircularPool_t * const pool, const void * const block) {
+	// Pool check.
+	assert(pool && ((const uint8_t *)block >= pool->blocks));
+
+	const uint32_t offset = (uint32_t)((const uint8_t *)block - pool->blocks);
+	assert(!(offset % pool->blockSize) && (offset / pool->blockSize < pool->count));
+	return (uint16_t)(offset / pool->blockSize);
+}
+
+/*
+ * @brief Gets a block by index.
+ * @param pool The pool.
+ * @param index Index of the block.
+ * @return Pointer to the block.
+ */
+void * CircularPool_at(const CircularPool_t * const pool, const uint16_t index) {
+	// Pool check.
+	assert(pool && (index < pool->count));
+
+	return pool->blocks + (uint32_t)index * pool->blockSize;
+}
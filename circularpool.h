@@ -0,0 +1,54 @@
+/**
+ * @file      circularpool.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Fixed-block pool allocator with a circular buffer of free block indices.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CIRCULARPOOL_H_
+#define _CIRCULARPOOL_H_
+
+// Includes.
+#include "circularbuffer.h"
+
+// Size of the free list memory in bytes for a number of blocks, 2 bytes per index plus the slot kept free.
+#define CIRCULARPOOL_FREELIST_LENGTH(count) (2UL * (count) + 1)
+
+// Type definitions.
+typedef struct{
+	CircularBufferObject_t freeList;
+	uint8_t * blocks;
+	uint32_t blockSize;
+	uint16_t count;
+}CircularPool_t;
+
+// Prototypes.
+void CircularPool_init(CircularPool_t * const pool, uint8_t * const blocks, const uint32_t blockSize, const uint16_t count, uint8_t * const freeListMemory);
+void * CircularPool_alloc(CircularPool_t * const pool);
+void CircularPool_free(CircularPool_t * const pool, void * const block);
+uint16_t CircularPool_getFreeCount(const CircularPool_t * const pool);
+uint16_t CircularPool_indexOf(const CircularPool_t * const pool, const void * const block);
+void * CircularPool_at(const CircularPool_t * const pool, const uint16_t index);
+
+#endif
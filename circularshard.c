@@ -0,0 +1,202 @@
+/**
+ * @file      circularshard.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Sharded circular buffers, one single-producer buffer per thread or core with a merging consumer.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#include "circularshard.h"
+#include <string.h>
+#include <assert.h>
+
+#ifndef CIRCULARBUFFER_TIMESTAMP
+#error "CircularShard needs a CIRCULARBUFFER_TIMESTAMP() source"
+#endif
+
+/*
+ * @brief Initializes the shards. Each buffer object is initialized by the application before, with its own memory.
+ *        Each shard must have a single producer, i.e. a thread, or a core that does not migrate its producer.
+ * @param shard The shard set.
+ * @param bufferObjects Array of the buffer objects, one per producer.
+ * @param count Number of buffer objects.
+ */
+void CircularShard_init(CircularShard_t * const shard, CircularBufferObject_t * const bufferObjects, const uint16_t count) {
+	// Buffer check.
+	assert(shard && bufferObjects && count);
+
+	shard->bufferObjects = bufferObjects;
+	shard->count = count;
+	shard->next = 0;
+	shard->discardedRecords = 0;
+}
+
+/*
+ * @brief Pushes a timestamped record into a shard, either whole or not at all. Called by the producer of the shard.
+ * @param shard The shard set.
+ * @param index Index of the shard of the caller.
+ * @param data Pointer to the record.
+ * @param len Size of the record.
+ * @return Returns true on success, false if the shard is full.
+ */
+bool CircularShard_push(CircularShard_t * const shard, const uint16_t index, const uint8_t * const data, const uint16_t len) {
+	// Shard check.
+	assert(shard && (index < shard->count));
+
+	// Header of the size and the timestamp, taken when the record is pushed.
+	uint8_t header[CIRCULARSHARD_HEADER_SIZE];
+	const uint32_t timestamp = CIRCULARBUFFER_TIMESTAMP();
+	memcpy(&header[0], &len, sizeof(len));
+	memcpy(&header[2], &timestamp, sizeof(timestamp));
+
+	// Header and record with a single back pointer update.
+	const CircularBufferVector_t vector[2] = {
+		{header, CIRCULARSHARD_HEADER_SIZE},
+		{(uint8_t *)data, len}
+	};
+	return CircularBuffer_pushBackV(&shard->bufferObjects[index], vector, 2, true) != 0;
+}
+
+/*
+ * @brief Reads the header of the next record of a shard.
+ * @param bufferObject The buffer object of the shard.
+ * @param len Pointer to write the size of the record.
+ * @param timestamp Pointer to write the timestamp of the record.
+ * @return Returns true if a record is available.
+ */
+static bool CircularShard_peekHeader(const CircularBufferObject_t * const bufferObject, uint16_t * const len, uint32_t * const timestamp) {
+	uint8_t header[CIRCULARSHARD_HEADER_SIZE];
+
+	// Records are pushed whole, so a header means the record is there.
+	if (CircularBuffer_peek(bufferObject, 0, header, CIRCULARSHARD_HEADER_SIZE) < CIRCULARSHARD_HEADER_SIZE) {
+		return false;
+	}
+	memcpy(len, &header[0], sizeof(*len));
+	memcpy(timestamp, &header[2], sizeof(*timestamp));
+	return true;
+}
+
+/*
+ * @brief Pops the next record of a shard with a single front pointer update. A record longer than maxlen is
+ *        discarded and counted.
+ * @param shard The shard set.
+ * @param index Index of the shard.
+ * @param data Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @param len Size of the record from the header.
+ * @return Returns true if the record was popped, false if it was discarded.
+ */
+static bool CircularShard_popRecord(CircularShard_t * const shard, const uint16_t index, uint8_t * const data, const uint16_t maxlen, const uint16_t len) {
+	CircularBufferObject_t * const bufferObject = &shard->bufferObjects[index];
+
+	// Too long for the client buffer.
+	if (len > maxlen) {
+		CircularBuffer_skip(bufferObject, CIRCULARSHARD_HEADER_SIZE + len);
+		shard->discardedRecords++;
+		return false;
+	}
+
+	// Header and record.
+	uint8_t header[CIRCULARSHARD_HEADER_SIZE];
+	const CircularBufferVector_t vector[2] = {
+		{header, CIRCULARSHARD_HEADER_SIZE},
+		{data, len}
+	};
+	CircularBuffer_popFrontV(bufferObject, vector, 2);
+	return true;
+}
+
+/*
+ * @brief Pops the next record, visiting the shards in turn so that no producer is starved.
+ * @param shard The shard set.
+ * @param data Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @param len Pointer to write the size of the record.
+ * @param index Pointer to write the index of the shard, may be NULL.
+ * @return Returns true if a record was popped, false if all shards are empty.
+ */
+bool CircularShard_popRoundRobin(CircularShard_t * const shard, uint8_t * const data, const uint16_t maxlen, uint16_t * const len, uint16_t * const index) {
+	// Shard check.
+	assert(shard && len);
+
+	// One round over the shards, starting after the last one popped.
+	for (uint16_t visited = 0; visited < shard->count; visited++) {
+		const uint16_t current = shard->next;
+		uint32_t timestamp;
+		shard->next = (current + 1 == shard->count) ? 0 : current + 1;
+		if (CircularShard_peekHeader(&shard->bufferObjects[current], len, &timestamp)
+			&& CircularShard_popRecord(shard, current, data, maxlen, *len)) {
+			if (index) {
+				*index = current;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * @brief Pops the oldest of the pending records by timestamp, so the records of all shards come out as one stream
+ *        in time order. A record pushed later with an older timestamp, i.e. by a preempted producer, can come out
+ *        after newer ones.
+ * @param shard The shard set.
+ * @param data Pointer to the output memory.
+ * @param maxlen Size of the output memory.
+ * @param len Pointer to write the size of the record.
+ * @param timestamp Pointer to write the timestamp of the record, may be NULL.
+ * @return Returns true if a record was popped, false if all shards are empty.
+ */
+bool CircularShard_popMerged(CircularShard_t * const shard, uint8_t * const data, const uint16_t maxlen, uint16_t * const len, uint32_t * const timestamp) {
+	// Shard check.
+	assert(shard && len);
+
+	for (;;) {
+		// Find the oldest head record, timestamps are compared wrap-safe.
+		uint16_t oldest = shard->count, oldestLen = 0;
+		uint32_t oldestTimestamp = 0;
+		for (uint16_t i = 0; i < shard->count; i++) {
+			uint16_t headLen;
+			uint32_t headTimestamp;
+			if (CircularShard_peekHeader(&shard->bufferObjects[i], &headLen, &headTimestamp)
+				&& ((oldest == shard->count) || ((int32_t)(headTimestamp - oldestTimestamp) < 0))) {
+				oldest = i;
+				oldestLen = headLen;
+				oldestTimestamp = headTimestamp;
+			}
+		}
+
+		// All empty.
+		if (oldest == shard->count) {
+			return false;
+		}
+
+		// Pop it, or try the next one if it was discarded.
+		if (CircularShard_popRecord(shard, oldest, data, maxlen, oldestLen)) {
+			*len = oldestLen;
+			if (timestamp) {
+				*timestamp = oldestTimestamp;
+			}
+			return true;
+		}
+	}
+}
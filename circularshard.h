@@ -0,0 +1,52 @@
+/**
+ * @file      circularshard.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Sharded circular buffers, one single-producer buffer per thread or core with a merging consumer.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _CIRCULARSHARD_H_
+#define _CIRCULARSHARD_H_
+
+// Includes.
+#include "circularbuffer.h"
+
+// Settings.
+#define CIRCULARSHARD_HEADER_SIZE 6
+
+// Type definitions.
+typedef struct{
+	CircularBufferObject_t * bufferObjects;
+	uint16_t count;
+	uint16_t next;
+	uint32_t discardedRecords;
+}CircularShard_t;
+
+// Prototypes.
+void CircularShard_init(CircularShard_t * const shard, CircularBufferObject_t * const bufferObjects, const uint16_t count);
+bool CircularShard_push(CircularShard_t * const shard, const uint16_t index, const uint8_t * const data, const uint16_t len);
+bool CircularShard_popRoundRobin(CircularShard_t * const shard, uint8_t * const data, const uint16_t maxlen, uint16_t * const len, uint16_t * const index);
+bool CircularShard_popMerged(CircularShard_t * const shard, uint8_t * const data, const uint16_t maxlen, uint16_t * const len, uint32_t * const timestamp);
+
+#endif
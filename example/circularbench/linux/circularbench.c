@@ -0,0 +1,316 @@
+/**
+ * @file      circularbench.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host microbenchmark for the circular buffer entry points.
+ * @usage     gcc -O2 -I../../.. circularbench.c ../../../circularbuffer.c -o circularbench
+ *            ./circularbench [-c cpu] [-r repetitions]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#define _GNU_SOURCE
+#include "circularbuffer.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Settings.
+#define BENCH_TARGET_NS 20000000ULL
+#define BENCH_DEFAULT_REPETITIONS 15
+
+// Type definitions.
+typedef void (*BenchFunction_t)(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations);
+typedef struct{
+	double nsPerOp;
+	double cyclesPerOp;
+	double spread;
+}BenchResult_t;
+
+// Variables.
+static uint8_t ringMemory[1UL << 16];
+static uint8_t sourceMemory[1UL << 16];
+static uint8_t sinkMemory[1UL << 16];
+static volatile uint32_t sink;
+
+/*
+ * @brief Reads the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static uint64_t Bench_nanoseconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * @brief Reads the cycle counter if the architecture has a cheap one.
+ * @return Cycle count, 0 if not available.
+ */
+static uint64_t Bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/*
+ * @brief Byte pusher and popper pairs, as in an interrupt handler.
+ */
+static void Bench_byteLoop(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	uint8_t data = 0;
+	for (uint64_t i = 0; i < iterations; i++) {
+		for (uint32_t n = 0; n < size; n++) {
+			CircularBuffer_pushBackByte(bufferObject, (uint8_t)n);
+		}
+		for (uint32_t n = 0; n < size; n++) {
+			CircularBuffer_popFrontByte(bufferObject, &data);
+		}
+	}
+	sink += data;
+}
+
+/*
+ * @brief Bulk push and pop that never cross the end of the memory.
+ */
+static void Bench_bulkLinear(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		bufferObject->front = bufferObject->back = 0;
+		CircularBuffer_pushBack(bufferObject, sourceMemory, (uint16_t)size);
+		CircularBuffer_popFront(bufferObject, sinkMemory, (uint16_t)size);
+	}
+	sink += sinkMemory[size - 1];
+}
+
+/*
+ * @brief Bulk push and pop that always cross the end of the memory.
+ */
+static void Bench_bulkWrapped(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	const uint16_t start = (uint16_t)(bufferObject->length - (size + 1) / 2);
+	for (uint64_t i = 0; i < iterations; i++) {
+		bufferObject->front = bufferObject->back = start;
+		CircularBuffer_pushBack(bufferObject, sourceMemory, (uint16_t)size);
+		CircularBuffer_popFront(bufferObject, sinkMemory, (uint16_t)size);
+	}
+	sink += sinkMemory[size - 1];
+}
+
+/*
+ * @brief A frame of 4-byte header, payload and 2-byte trailer pushed by three calls, popped by one.
+ */
+static void Bench_framePieces(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	for (uint64_t i = 0; i < iterations; i++) {
+		bufferObject->front = bufferObject->back = 0;
+		CircularBuffer_pushBack(bufferObject, sourceMemory, 4);
+		CircularBuffer_pushBack(bufferObject, sourceMemory + 4, (uint16_t)(size - 6));
+		CircularBuffer_pushBack(bufferObject, sourceMemory + size - 2, 2);
+		CircularBuffer_popFront(bufferObject, sinkMemory, (uint16_t)size);
+	}
+	sink += sinkMemory[size - 1];
+}
+
+/*
+ * @brief The same frame pushed by one vector call.
+ */
+static void Bench_frameVector(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	const CircularBufferVector_t vector[3] = {
+		{sourceMemory, 4},
+		{sourceMemory + 4, (uint16_t)(size - 6)},
+		{sourceMemory + size - 2, 2}
+	};
+	for (uint64_t i = 0; i < iterations; i++) {
+		bufferObject->front = bufferObject->back = 0;
+		CircularBuffer_pushBackV(bufferObject, vector, 3, true);
+		CircularBuffer_popFront(bufferObject, sinkMemory, (uint16_t)size);
+	}
+	sink += sinkMemory[size - 1];
+}
+
+/*
+ * @brief Unread size snapshot.
+ */
+static void Bench_getUnreadSize(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	uint32_t sum = 0;
+	bufferObject->front = 0;
+	bufferObject->back = (uint16_t)size;
+	for (uint64_t i = 0; i < iterations; i++) {
+		sum += CircularBuffer_getUnreadSize(bufferObject);
+	}
+	sink += sum;
+}
+
+/*
+ * @brief Fault check without clearing the buffer.
+ */
+static void Bench_checkAndClearFault(CircularBufferObject_t * const bufferObject, const uint32_t size, const uint64_t iterations) {
+	uint32_t sum = 0;
+	(void)size;
+	for (uint64_t i = 0; i < iterations; i++) {
+		bufferObject->faultFlag = (uint16_t)(i & 1);
+		sum += CircularBuffer_checkAndClearFault(bufferObject, false);
+	}
+	sink += sum;
+}
+
+/*
+ * @brief Compares doubles for qsort.
+ */
+static int Bench_compare(const void * a, const void * b) {
+	const double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * @brief Runs a benchmark with warmup, calibration and repetitions.
+ * @param function The benchmark function.
+ * @param length Ring size in bytes.
+ * @param size Size parameter for the function.
+ * @param repetitions Number of measured repetitions.
+ * @return Median time and cycles per iteration, and the p10-p90 spread relative to the median.
+ */
+static BenchResult_t Bench_run(const BenchFunction_t function, const uint32_t length, const uint32_t size, const uint32_t repetitions) {
+	CircularBufferObject_t bufferObject;
+	double ns[repetitions], cycles[repetitions];
+	BenchResult_t result;
+	CircularBuffer_initWithLength(&bufferObject, ringMemory, length);
+
+	// Warmup and calibrate the iteration count to the target time.
+	uint64_t iterations = 1;
+	for (;;) {
+		const uint64_t start = Bench_nanoseconds();
+		function(&bufferObject, size, iterations);
+		const uint64_t elapsed = Bench_nanoseconds() - start;
+		if (elapsed >= BENCH_TARGET_NS / 4) {
+			iterations = iterations * BENCH_TARGET_NS / (elapsed ? elapsed : 1) + 1;
+			break;
+		}
+		iterations *= 2;
+	}
+
+	// Measure.
+	for (uint32_t r = 0; r < repetitions; r++) {
+		const uint64_t startCycles = Bench_cycles();
+		const uint64_t start = Bench_nanoseconds();
+		function(&bufferObject, size, iterations);
+		const uint64_t elapsed = Bench_nanoseconds() - start;
+		const uint64_t elapsedCycles = Bench_cycles() - startCycles;
+		ns[r] = (double)elapsed / (double)iterations;
+		cycles[r] = (double)elapsedCycles / (double)iterations;
+	}
+
+	// Median is robust to scheduling noise, spread shows stability.
+	qsort(ns, repetitions, sizeof(double), Bench_compare);
+	qsort(cycles, repetitions, sizeof(double), Bench_compare);
+	result.nsPerOp = ns[repetitions / 2];
+	result.cyclesPerOp = cycles[repetitions / 2];
+	result.spread = (ns[(repetitions * 9) / 10] - ns[repetitions / 10]) / result.nsPerOp;
+	return result;
+}
+
+/*
+ * @brief Prints a result row.
+ * @param name Benchmark name.
+ * @param size Bytes moved per iteration, 0 for non-copying calls.
+ * @param result The result.
+ */
+static void Bench_print(const char * const name, const uint32_t size, const BenchResult_t result) {
+	if (size) {
+		printf("%-20s %8u %12.2f %12.1f %12.3f %7.1f%%\n", name, size, result.nsPerOp,
+			(double)size * 1e3 / result.nsPerOp, result.cyclesPerOp / size, result.spread * 100.0);
+	} else {
+		printf("%-20s %8s %12.2f %12s %12.2f %7.1f%%\n", name, "-", result.nsPerOp, "-", result.cyclesPerOp, result.spread * 100.0);
+	}
+}
+
+int main(int argc, char ** argv) {
+	uint32_t repetitions = BENCH_DEFAULT_REPETITIONS;
+	int cpu = 0, option;
+	static const uint32_t sizes[] = {1, 2, 4, 8, 16, 32, 64, 256, 1024, 4096, 16384, 65535};
+
+	// Options.
+	while ((option = getopt(argc, argv, "c:r:")) != -1) {
+		if (option == 'c') {
+			cpu = atoi(optarg);
+		} else if (option == 'r') {
+			repetitions = (uint32_t)atoi(optarg);
+		} else {
+			fprintf(stderr, "usage: %s [-c cpu] [-r repetitions]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (repetitions < 3) {
+		repetitions = 3;
+	}
+
+	// Pin to a single CPU to avoid migrations.
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set)) {
+		perror("sched_setaffinity");
+	}
+	memset(sourceMemory, 0xA5, sizeof(sourceMemory));
+
+	// Columns: per iteration time, bytes/s (MB/s), cycles/byte (cycles/op for non-copying calls).
+	printf("cpu %d, %u repetitions, median of each\n", cpu, repetitions);
+	printf("%-20s %8s %12s %12s %12s %8s\n", "benchmark", "bytes", "ns/op", "MB/s", "cycles/byte", "spread");
+	Bench_print("getUnreadSize", 0, Bench_run(Bench_getUnreadSize, 1UL << 16, 100, repetitions));
+	Bench_print("checkAndClearFault", 0, Bench_run(Bench_checkAndClearFault, 1UL << 16, 0, repetitions));
+	Bench_print("push/popByte", 64, Bench_run(Bench_byteLoop, 1UL << 10, 64, repetitions));
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		Bench_print("push/pop linear", sizes[i], Bench_run(Bench_bulkLinear, 1UL << 16, sizes[i], repetitions));
+	}
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		if (sizes[i] > 1) {
+			Bench_print("push/pop wrapped", sizes[i], Bench_run(Bench_bulkWrapped, 1UL << 16, sizes[i], repetitions));
+		}
+	}
+
+	// Each size class of the inline copy, with the memcpy call just above it.
+	static const uint32_t smallSizes[] = {1, 2, 3, 4, 6, 8, 12, 16, 17};
+	for (uint32_t i = 0; i < sizeof(smallSizes) / sizeof(smallSizes[0]); i++) {
+		Bench_print("push/pop small", smallSizes[i], Bench_run(Bench_bulkLinear, 1UL << 16, smallSizes[i], repetitions));
+	}
+
+	// Composite frames, pushed piecewise and as a vector.
+	static const uint32_t frameSizes[] = {16, 64, 256};
+	for (uint32_t i = 0; i < sizeof(frameSizes) / sizeof(frameSizes[0]); i++) {
+		Bench_print("frame 3x pushBack", frameSizes[i], Bench_run(Bench_framePieces, 1UL << 16, frameSizes[i], repetitions));
+		Bench_print("frame pushBackV", frameSizes[i], Bench_run(Bench_frameVector, 1UL << 16, frameSizes[i], repetitions));
+	}
+
+	// Same with a length that is not a power of 2.
+	Bench_print("push/popByte 1000", 64, Bench_run(Bench_byteLoop, 1000, 64, repetitions));
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		if ((sizes[i] > 1) && (sizes[i] < 40000)) {
+			Bench_print("wrapped 40000", sizes[i], Bench_run(Bench_bulkWrapped, 40000, sizes[i], repetitions));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file      circularshardbench.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host scaling benchmark of sharded per-thread buffers against one mutex-guarded buffer.
+ * @usage     gcc -O2 -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularshardbench.c ../../../circularshard.c ../../../circularbuffer.c -o circularshardbench
+ *            ./circularshardbench [-p max producers] [-s record bytes] [-t seconds] [-r]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#define _GNU_SOURCE
+#include "circularshard.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Settings.
+#define SHARD_MAX_PRODUCERS 64
+#define SHARD_RING_LENGTH 65536
+#define SHARD_RECORD_MAX 1024
+
+// Type definitions.
+typedef struct{
+	uint16_t index;
+	uint32_t size;
+	uint64_t records;
+}ShardProducer_t;
+
+// Variables.
+static CircularBufferObject_t bufferObjects[SHARD_MAX_PRODUCERS];
+static uint8_t * memories[SHARD_MAX_PRODUCERS];
+static CircularShard_t shard;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile bool stop;
+static bool useMutex;
+static bool roundRobin;
+static int cpus;
+
+/*
+ * @brief Reads the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static uint64_t Shard_nanoseconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * @brief Pins the calling thread to a CPU, modulo the online CPUs.
+ * @param cpu The CPU number.
+ */
+static void Shard_pin(const int cpu) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu % cpus, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/*
+ * @brief Pushes sequence-numbered records to its own shard, or to the shared buffer under the mutex.
+ */
+static void * Shard_produce(void * const argument) {
+	ShardProducer_t * const producer = argument;
+	uint8_t record[SHARD_RECORD_MAX] = {0};
+	uint64_t sequence = 0;
+	Shard_pin(producer->index + 1);
+	memcpy(record, &producer->index, sizeof(producer->index));
+	while (!stop) {
+		memcpy(&record[2], &sequence, sizeof(sequence));
+		bool pushed;
+		if (useMutex) {
+			pthread_mutex_lock(&mutex);
+			pushed = CircularShard_push(&shard, 0, record, (uint16_t)producer->size);
+			pthread_mutex_unlock(&mutex);
+		} else {
+			pushed = CircularShard_push(&shard, producer->index, record, (uint16_t)producer->size);
+		}
+		if (pushed) {
+			sequence++;
+		} else {
+			sched_yield();
+		}
+	}
+	producer->records = sequence;
+	return NULL;
+}
+
+/*
+ * @brief Runs producers against one consumer and prints the aggregate rate.
+ * @param producers Number of producers.
+ * @param size Record size.
+ * @param seconds Duration.
+ */
+static void Shard_run(const uint16_t producers, const uint32_t size, const double seconds) {
+	ShardProducer_t producer[SHARD_MAX_PRODUCERS];
+	pthread_t thread[SHARD_MAX_PRODUCERS];
+	uint64_t expected[SHARD_MAX_PRODUCERS] = {0}, consumed = 0;
+	uint8_t record[SHARD_RECORD_MAX];
+	bool failed = false;
+
+	// One shard per producer, or a single shared one.
+	for (uint16_t i = 0; i < producers; i++) {
+		CircularBuffer_initWithLength(&bufferObjects[i], memories[i], SHARD_RING_LENGTH);
+	}
+	CircularShard_init(&shard, bufferObjects, useMutex ? 1 : producers);
+	stop = false;
+	Shard_pin(0);
+	const uint64_t start = Shard_nanoseconds();
+	for (uint16_t i = 0; i < producers; i++) {
+		producer[i] = (ShardProducer_t){i, size, 0};
+		pthread_create(&thread[i], NULL, Shard_produce, &producer[i]);
+	}
+
+	// Drain and check the order of each producer.
+	const uint64_t end = start + (uint64_t)(seconds * 1e9);
+	for (uint32_t idle = 0; !stop || (idle < 2); ) {
+		uint16_t len, index;
+		uint64_t sequence;
+		bool popped;
+		if (!stop && (Shard_nanoseconds() >= end)) {
+			stop = true;
+			for (uint16_t i = 0; i < producers; i++) {
+				pthread_join(thread[i], NULL);
+			}
+		}
+		if (useMutex) {
+			pthread_mutex_lock(&mutex);
+		}
+		popped = roundRobin ? CircularShard_popRoundRobin(&shard, record, sizeof(record), &len, NULL)
+			: CircularShard_popMerged(&shard, record, sizeof(record), &len, NULL);
+		if (useMutex) {
+			pthread_mutex_unlock(&mutex);
+		}
+		if (!popped) {
+			idle += stop;
+			sched_yield();
+			continue;
+		}
+		memcpy(&index, record, sizeof(index));
+		memcpy(&sequence, &record[2], sizeof(sequence));
+		failed |= (index >= producers) || (sequence != expected[index]++);
+		consumed++;
+	}
+
+	// Every pushed record must come out.
+	const double elapsed = (double)(Shard_nanoseconds() - start) / 1e9;
+	for (uint16_t i = 0; i < producers; i++) {
+		failed |= (producer[i].records != expected[i]);
+	}
+	printf("%-8s %10u %8u %12.0f %s\n", useMutex ? "mutex" : (roundRobin ? "rr" : "merged"), producers, size,
+		(double)consumed / elapsed / 1e3, failed ? "ORDER ERROR" : "");
+}
+
+int main(int argc, char ** argv) {
+	int maxProducers, option;
+	uint32_t size = 32;
+	double seconds = 1.0;
+
+	// Options.
+	cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	maxProducers = (cpus > 1) ? cpus - 1 : 1;
+	while ((option = getopt(argc, argv, "p:s:t:r")) != -1) {
+		if (option == 'p') {
+			maxProducers = atoi(optarg);
+		} else if (option == 's') {
+			size = (uint32_t)atoi(optarg);
+		} else if (option == 't') {
+			seconds = atof(optarg);
+		} else if (option == 'r') {
+			roundRobin = true;
+		} else {
+			fprintf(stderr, "usage: %s [-p max producers] [-s record bytes] [-t seconds] [-r]\n", argv[0]);
+			return 1;
+		}
+	}
+	if ((maxProducers < 1) || (maxProducers > SHARD_MAX_PRODUCERS) || (size < 10) || (size > SHARD_RECORD_MAX)) {
+		fprintf(stderr, "1 to %d producers, 10 to %d byte records\n", SHARD_MAX_PRODUCERS, SHARD_RECORD_MAX);
+		return 1;
+	}
+	for (int i = 0; i < maxProducers; i++) {
+		memories[i] = malloc(SHARD_RING_LENGTH);
+		if (!memories[i]) {
+			return 1;
+		}
+	}
+
+	// Sharded against all producers on one buffer under a mutex, the consumer is on cpu 0.
+	printf("%d cpus, producers on cpu 1 and up\n", cpus);
+	printf("%-8s %10s %8s %12s\n", "variant", "producers", "bytes", "krecords/s");
+	for (uint32_t m = 0; m < 2; m++) {
+		useMutex = m;
+		for (int p = 1; p <= maxProducers; p *= 2) {
+			Shard_run((uint16_t)p, size, seconds);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,372 @@
+/**
+ * @file      circularspscbench.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host cross-core latency and throughput benchmark for a single-producer single-consumer circular buffer.
+ * @usage     gcc -O2 -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularspscbench.c ../../../circularbuffer.c -o circularspscbench
+ *            ./circularspscbench [-p producer cpu] [-c consumer cpu] [-n pingpong samples] [-t stream seconds]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#define _GNU_SOURCE
+#include "circularbuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Settings.
+#define SPSC_RING_2N 16
+#define SPSC_MESSAGE_MAX 4096
+#define SPSC_YIELD_SPINS 256
+
+// Type definitions.
+typedef struct{
+	CircularBufferObject_t bufferObject;
+	pthread_mutex_t mutex;
+	uint8_t memory[1UL << SPSC_RING_2N];
+}SpscRing_t;
+typedef struct{
+	SpscRing_t * rx;
+	SpscRing_t * tx;
+	uint32_t size;
+	uint64_t count;
+	int cpu;
+	volatile bool * stop;
+	uint64_t messages;
+	bool failed;
+}SpscThread_t;
+
+// Variables.
+static SpscRing_t rings[2];
+static bool useMutex;
+
+/*
+ * @brief Reads the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static uint64_t Spsc_nanoseconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * @brief Pins the calling thread to a CPU.
+ * @param cpu The CPU number.
+ */
+static void Spsc_pin(const int cpu) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+		fprintf(stderr, "cannot pin to cpu %d\n", cpu);
+	}
+}
+
+/*
+ * @brief Reads a CPU topology attribute from sysfs.
+ * @param cpu The CPU number.
+ * @param name The attribute name.
+ * @return The attribute value, -1 if not available.
+ */
+static int Spsc_topology(const int cpu, const char * const name) {
+	char path[128];
+	int value = -1;
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+	FILE * file = fopen(path, "r");
+	if (file) {
+		if (fscanf(file, "%d", &value) != 1) {
+			value = -1;
+		}
+		fclose(file);
+	}
+	return value;
+}
+
+/*
+ * @brief Describes how two CPUs are related.
+ * @param a First CPU.
+ * @param b Second CPU.
+ * @return Relation name.
+ */
+static const char * Spsc_relation(const int a, const int b) {
+	if (a == b) {
+		return "same core";
+	}
+	if (Spsc_topology(a, "physical_package_id") != Spsc_topology(b, "physical_package_id")) {
+		return "cross socket";
+	}
+	if ((Spsc_topology(a, "core_id") >= 0) && (Spsc_topology(a, "core_id") == Spsc_topology(b, "core_id"))) {
+		return "SMT siblings";
+	}
+	return "same socket";
+}
+
+/*
+ * @brief Backs off after an unsuccessful poll, yielding so both sides can share a core.
+ * @param spins Poll counter of the caller.
+ */
+static inline void Spsc_wait(uint32_t * const spins) {
+	if (++*spins >= SPSC_YIELD_SPINS) {
+		*spins = 0;
+		sched_yield();
+	}
+}
+
+/*
+ * @brief Pushes a whole message if there is space, with or without the mutex baseline.
+ * @param ring The ring.
+ * @param data The message.
+ * @param size The message size.
+ * @return Returns true if the message was pushed.
+ */
+static bool Spsc_push(SpscRing_t * const ring, const uint8_t * const data, const uint16_t size) {
+	bool result = false;
+	if (useMutex) {
+		pthread_mutex_lock(&ring->mutex);
+	}
+	if ((uint16_t)(ring->bufferObject.capacity - CircularBuffer_getUnreadSize(&ring->bufferObject)) >= size) {
+		result = (CircularBuffer_pushBack(&ring->bufferObject, data, size) == size);
+	}
+	if (useMutex) {
+		pthread_mutex_unlock(&ring->mutex);
+	}
+	return result;
+}
+
+/*
+ * @brief Pops a whole message if available, with or without the mutex baseline.
+ * @param ring The ring.
+ * @param data The message memory.
+ * @param size The message size.
+ * @return Returns true if the message was popped.
+ */
+static bool Spsc_pop(SpscRing_t * const ring, uint8_t * const data, const uint16_t size) {
+	bool result = false;
+	if (useMutex) {
+		pthread_mutex_lock(&ring->mutex);
+	}
+	if (CircularBuffer_getUnreadSize(&ring->bufferObject) >= size) {
+		result = (CircularBuffer_popFront(&ring->bufferObject, data, size) == size);
+	}
+	if (useMutex) {
+		pthread_mutex_unlock(&ring->mutex);
+	}
+	return result;
+}
+
+/*
+ * @brief Echoes messages back until stopped.
+ */
+static void * Spsc_echo(void * const argument) {
+	SpscThread_t * const thread = argument;
+	uint8_t message[SPSC_MESSAGE_MAX];
+	uint32_t spins = 0;
+	Spsc_pin(thread->cpu);
+	while (!*thread->stop) {
+		if (!Spsc_pop(thread->rx, message, (uint16_t)thread->size)) {
+			Spsc_wait(&spins);
+			continue;
+		}
+		while (!Spsc_push(thread->tx, message, (uint16_t)thread->size)) {
+			Spsc_wait(&spins);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * @brief Consumes sequence-numbered messages until stopped, checking the order.
+ */
+static void * Spsc_consume(void * const argument) {
+	SpscThread_t * const thread = argument;
+	uint8_t message[SPSC_MESSAGE_MAX];
+	uint64_t expected = 0, sequence;
+	uint32_t spins = 0;
+	Spsc_pin(thread->cpu);
+	while (!*thread->stop || CircularBuffer_getUnreadSize(&thread->rx->bufferObject)) {
+		if (!Spsc_pop(thread->rx, message, (uint16_t)thread->size)) {
+			Spsc_wait(&spins);
+			continue;
+		}
+		memcpy(&sequence, message, sizeof(sequence));
+		if (sequence != expected++) {
+			thread->failed = true;
+		}
+	}
+	thread->messages = expected;
+	return NULL;
+}
+
+/*
+ * @brief Compares timestamps for qsort.
+ */
+static int Spsc_compare(const void * a, const void * b) {
+	const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * @brief Resets both rings.
+ */
+static void Spsc_reset(void) {
+	for (uint32_t i = 0; i < 2; i++) {
+		CircularBuffer_init(&rings[i].bufferObject, rings[i].memory, SPSC_RING_2N);
+	}
+}
+
+/*
+ * @brief Measures one-way latency as half of the round trip of a timestamped message.
+ * @param producer Producer CPU.
+ * @param consumer Consumer CPU.
+ * @param size Message size, at least the timestamp.
+ * @param samples Number of round trips.
+ */
+static void Spsc_pingPong(const int producer, const int consumer, const uint32_t size, const uint64_t samples) {
+	uint8_t message[SPSC_MESSAGE_MAX] = {0};
+	uint64_t * const latency = malloc(samples * sizeof(uint64_t));
+	volatile bool stop = false;
+	SpscThread_t echo = {&rings[0], &rings[1], size, 0, consumer, &stop, 0, false};
+	pthread_t thread;
+	uint32_t spins = 0;
+	if (!latency) {
+		return;
+	}
+	Spsc_reset();
+	Spsc_pin(producer);
+	pthread_create(&thread, NULL, Spsc_echo, &echo);
+
+	// Warmup included, the first tenth is discarded.
+	const uint64_t warmup = samples / 10;
+	for (uint64_t i = 0; i < samples + warmup; i++) {
+		const uint64_t start = Spsc_nanoseconds();
+		memcpy(message, &start, sizeof(start));
+		while (!Spsc_push(&rings[0], message, (uint16_t)size)) {
+			Spsc_wait(&spins);
+		}
+		while (!Spsc_pop(&rings[1], message, (uint16_t)size)) {
+			Spsc_wait(&spins);
+		}
+		if (i >= warmup) {
+			uint64_t sent;
+			memcpy(&sent, message, sizeof(sent));
+			latency[i - warmup] = (Spsc_nanoseconds() - sent) / 2;
+		}
+	}
+	stop = true;
+	pthread_join(thread, NULL);
+
+	// Percentiles.
+	qsort(latency, samples, sizeof(uint64_t), Spsc_compare);
+	printf("%-8s %-10s %8u %10llu %10llu %10llu %10llu\n", useMutex ? "mutex" : "lockfree", "pingpong", size,
+		(unsigned long long)latency[samples / 2], (unsigned long long)latency[(samples * 99) / 100],
+		(unsigned long long)latency[(samples * 999) / 1000], (unsigned long long)latency[samples - 1]);
+	free(latency);
+}
+
+/*
+ * @brief Measures sustained throughput of sequence-numbered messages.
+ * @param producer Producer CPU.
+ * @param consumer Consumer CPU.
+ * @param size Message size, at least the sequence number.
+ * @param seconds Duration.
+ */
+static void Spsc_stream(const int producer, const int consumer, const uint32_t size, const double seconds) {
+	uint8_t message[SPSC_MESSAGE_MAX] = {0};
+	volatile bool stop = false;
+	SpscThread_t sink = {&rings[0], NULL, size, 0, consumer, &stop, 0, false};
+	pthread_t thread;
+	uint32_t spins = 0;
+	Spsc_reset();
+	Spsc_pin(producer);
+	pthread_create(&thread, NULL, Spsc_consume, &sink);
+
+	const uint64_t start = Spsc_nanoseconds();
+	const uint64_t end = start + (uint64_t)(seconds * 1e9);
+	for (uint64_t sequence = 0; ; sequence++) {
+		memcpy(message, &sequence, sizeof(sequence));
+		while (!Spsc_push(&rings[0], message, (uint16_t)size)) {
+			Spsc_wait(&spins);
+		}
+		if (!(sequence & 0xFF) && (Spsc_nanoseconds() >= end)) {
+			break;
+		}
+	}
+	stop = true;
+	pthread_join(thread, NULL);
+
+	const double elapsed = (double)(Spsc_nanoseconds() - start) / 1e9;
+	printf("%-8s %-10s %8u %10.0f %10.1f %s\n", useMutex ? "mutex" : "lockfree", "stream", size,
+		(double)sink.messages / elapsed / 1e3, (double)sink.messages * size / elapsed / 1e6, sink.failed ? "ORDER ERROR" : "");
+}
+
+int main(int argc, char ** argv) {
+	int producer = 0, consumer = 1, option;
+	uint64_t samples = 100000;
+	double seconds = 1.0;
+	static const uint32_t sizes[] = {8, 16, 64, 256, 1024, 4096};
+
+	// Options.
+	while ((option = getopt(argc, argv, "p:c:n:t:")) != -1) {
+		if (option == 'p') {
+			producer = atoi(optarg);
+		} else if (option == 'c') {
+			consumer = atoi(optarg);
+		} else if (option == 'n') {
+			samples = strtoull(optarg, NULL, 0);
+		} else if (option == 't') {
+			seconds = atof(optarg);
+		} else {
+			fprintf(stderr, "usage: %s [-p producer cpu] [-c consumer cpu] [-n pingpong samples] [-t stream seconds]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (samples < 1000) {
+		samples = 1000;
+	}
+	for (uint32_t i = 0; i < 2; i++) {
+		pthread_mutex_init(&rings[i].mutex, NULL);
+	}
+
+	// Lock-free ring against the same API guarded by a mutex.
+	printf("producer cpu %d, consumer cpu %d (%s)\n", producer, consumer, Spsc_relation(producer, consumer));
+	printf("%-8s %-10s %8s %10s %10s %10s %10s\n", "variant", "mode", "bytes", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+	for (uint32_t m = 0; m < 2; m++) {
+		useMutex = m;
+		for (uint32_t i = 0; i < 3; i++) {
+			Spsc_pingPong(producer, consumer, sizes[i], samples);
+		}
+	}
+	printf("%-8s %-10s %8s %10s %10s\n", "variant", "mode", "bytes", "kmsg/s", "MB/s");
+	for (uint32_t m = 0; m < 2; m++) {
+		useMutex = m;
+		for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+			Spsc_stream(producer, consumer, sizes[i], seconds);
+		}
+	}
+	return 0;
+}
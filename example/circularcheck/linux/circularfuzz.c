@@ -0,0 +1,368 @@
+/**
+ * @file      circularfuzz.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Fuzz target of the circular buffer. The input picks a buffer length and watermarks, then a sequence of
+ *            CircularBuffer_* calls that run against the buffer and a linear reference model. Every result, the
+ *            unread data, the fault flag and the watermark reports are compared, and CircularBuffer_checkInvariants()
+ *            must hold after each call. The buffer memory is allocated at its exact length, so AddressSanitizer
+ *            catches any access past it.
+ * @usage     clang -O1 -g -fsanitize=fuzzer,address,undefined -DCIRCULARFUZZ_MAIN=0 -DCIRCULARBUFFER_STATISTICS=1
+ *              -I../../.. circularfuzz.c ../../../circularbuffer.c -o circularfuzz
+ *            ./circularfuzz corpus/
+ *            Without libFuzzer the file has its own driver, which runs random inputs or replays the given files:
+ *            gcc -O1 -g -fsanitize=address,undefined -DCIRCULARBUFFER_STATISTICS=1 -I../../.. circularfuzz.c
+ *              ../../../circularbuffer.c -o circularfuzz
+ *            ./circularfuzz [iterations | files]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularbuffer.h"
+#include <stdlib.h>
+
+// Settings.
+#ifndef CIRCULARFUZZ_MAIN
+#define CIRCULARFUZZ_MAIN 1
+#endif
+#define FUZZ_MAX_LENGTH 2048
+#define FUZZ_MAX_INPUT 4096
+
+// Type definitions.
+typedef struct{
+	const uint8_t * data;
+	size_t len;
+}FuzzInput_t;
+typedef struct{
+	uint8_t data[FUZZ_MAX_LENGTH];
+	uint16_t count;
+	bool fault;
+	bool high;
+	uint8_t next;
+}FuzzModel_t;
+
+// Variables.
+static uint32_t operation;
+static uint32_t reports;
+static bool reportedHigh;
+
+// Fails the input, libFuzzer saves it as a crash.
+#define Fuzz_check(condition, message) do { \
+		if (!(condition)) { \
+			printf("FAIL: %s (operation %u)\n", (message), operation); \
+			fflush(stdout); \
+			abort(); \
+		} \
+	} while (0)
+
+/*
+ * @brief Takes the next byte of the input, 0 once it is used up.
+ */
+static uint8_t Fuzz_byte(FuzzInput_t * const input) {
+	if (!input->len) {
+		return 0;
+	}
+	input->len--;
+	return *input->data++;
+}
+
+/*
+ * @brief Takes a size from 0 to limit from the next 2 bytes of the input.
+ */
+static uint16_t Fuzz_size(FuzzInput_t * const input, const uint16_t limit) {
+	const uint16_t low = Fuzz_byte(input);
+	const uint16_t value = low | ((uint16_t)Fuzz_byte(input) << 8);
+	return (uint16_t)(value % ((uint32_t)limit + 1));
+}
+
+/*
+ * @brief Fills data that the model tracks, a running counter so that lost or repeated bytes show.
+ */
+static void Fuzz_fill(FuzzModel_t * const model, uint8_t * const data, const uint16_t len) {
+	for (uint16_t i = 0; i < len; i++) {
+		data[i] = model->next++;
+	}
+}
+
+/*
+ * @brief Appends pushed data to the model.
+ */
+static void Fuzz_modelPush(FuzzModel_t * const model, const uint8_t * const data, const uint16_t len) {
+	memcpy(&model->data[model->count], data, len);
+	model->count += len;
+}
+
+/*
+ * @brief Checks popped data against the model and removes it.
+ */
+static void Fuzz_modelPop(FuzzModel_t * const model, const uint8_t * const data, const uint16_t len) {
+	Fuzz_check(!memcmp(data, model->data, len), "popped data differs");
+	memmove(model->data, &model->data[len], model->count - len);
+	model->count -= len;
+}
+
+/*
+ * @brief Watermark callback, on a single thread the edges must alternate.
+ */
+static void Fuzz_watermark(CircularBufferObject_t * const bufferObject, const bool high) {
+	(void)bufferObject;
+	Fuzz_check(!reports || (high != reportedHigh), "watermark edge reported twice");
+	reportedHigh = high;
+	reports++;
+}
+
+/*
+ * @brief Runs one input.
+ * @param data The input.
+ * @param size Size of the input.
+ * @return Always 0.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size) {
+	static FuzzModel_t model;
+	static uint8_t scratch[sizeof(CircularBufferSnapshot_t) + FUZZ_MAX_LENGTH];
+	FuzzInput_t input = {data, size};
+	CircularBufferObject_t buffer;
+
+	// Power of 2 or any length, the memory is exactly that long.
+	const uint8_t shape = Fuzz_byte(&input);
+	const uint32_t length = (shape & 0x80) ? (1UL << (shape % 12)) : 1UL + Fuzz_size(&input, FUZZ_MAX_LENGTH - 1);
+	uint8_t * const memory = malloc(length);
+	CircularBuffer_initWithLength(&buffer, memory, length);
+	const uint16_t capacity = buffer.capacity;
+	memset(&model, 0, sizeof(model));
+	operation = 0;
+	reports = 0;
+	reportedHigh = false;
+
+	// Watermarks, low below high.
+	if (capacity) {
+		const uint16_t high = 1 + Fuzz_size(&input, capacity - 1);
+		CircularBuffer_setWatermarks(&buffer, high, Fuzz_size(&input, high - 1), Fuzz_watermark);
+	}
+
+	while (input.len) {
+		const uint16_t before = model.count;
+		const uint16_t free = capacity - model.count;
+		switch (Fuzz_byte(&input) % 14) {
+		case 0: {
+			uint8_t byte;
+			Fuzz_fill(&model, &byte, 1);
+			const bool pushed = CircularBuffer_pushBackByte(&buffer, byte);
+			Fuzz_check(pushed == (free > 0), "pushBackByte result");
+			if (pushed) {
+				Fuzz_modelPush(&model, &byte, 1);
+			} else {
+				model.fault = true;
+			}
+			break;
+		}
+		case 1: {
+			uint8_t byte;
+			const bool popped = CircularBuffer_popFrontByte(&buffer, &byte);
+			Fuzz_check(popped == (model.count > 0), "popFrontByte result");
+			if (popped) {
+				Fuzz_modelPop(&model, &byte, 1);
+			}
+			break;
+		}
+		case 2: {
+			const uint16_t len = Fuzz_size(&input, capacity + 1);
+			Fuzz_fill(&model, scratch, len);
+			const uint16_t pushed = CircularBuffer_pushBack(&buffer, scratch, len);
+			Fuzz_check(pushed == ((len < free) ? len : free), "pushBack size");
+			Fuzz_modelPush(&model, scratch, pushed);
+			break;
+		}
+		case 3: {
+			const uint16_t len = Fuzz_size(&input, capacity + 1);
+			const uint16_t popped = CircularBuffer_popFront(&buffer, scratch, len);
+			Fuzz_check(popped == ((len < model.count) ? len : model.count), "popFront size");
+			Fuzz_modelPop(&model, scratch, popped);
+			break;
+		}
+		case 4: {
+			const uint16_t first = Fuzz_size(&input, capacity / 2 + 1);
+			const uint16_t second = Fuzz_size(&input, capacity / 2 + 1);
+			const bool allOrNothing = Fuzz_byte(&input) & 1;
+			Fuzz_fill(&model, scratch, first + second);
+			const CircularBufferVector_t vector[2] = {{scratch, first}, {&scratch[first], second}};
+			const uint16_t pushed = CircularBuffer_pushBackV(&buffer, vector, 2, allOrNothing);
+			const uint16_t total = first + second;
+			Fuzz_check(pushed == ((total <= free) ? total : (allOrNothing ? 0 : free)), "pushBackV size");
+			Fuzz_modelPush(&model, scratch, pushed);
+			break;
+		}
+		case 5: {
+			const uint16_t first = Fuzz_size(&input, capacity / 2 + 1);
+			const uint16_t second = Fuzz_size(&input, capacity / 2 + 1);
+			const CircularBufferVector_t vector[2] = {{scratch, first}, {&scratch[first], second}};
+			const uint16_t popped = CircularBuffer_popFrontV(&buffer, vector, 2);
+			Fuzz_check(popped == ((first + second < model.count) ? first + second : model.count), "popFrontV size");
+			Fuzz_modelPop(&model, scratch, popped);
+			break;
+		}
+		case 6: {
+			const uint16_t offset = Fuzz_size(&input, capacity + 1);
+			uint8_t byte = 0;
+			const bool peeked = CircularBuffer_peekAt(&buffer, offset, &byte);
+			Fuzz_check(peeked == (offset < model.count), "peekAt result");
+			Fuzz_check(!peeked || (byte == model.data[offset]), "peekAt data");
+			break;
+		}
+		case 7: {
+			const uint16_t offset = Fuzz_size(&input, capacity + 1);
+			const uint16_t len = Fuzz_size(&input, capacity + 1);
+			const uint16_t peeked = CircularBuffer_peek(&buffer, offset, scratch, len);
+			const uint16_t after = (offset < model.count) ? model.count - offset : 0;
+			Fuzz_check(peeked == ((len < after) ? len : after), "peek size");
+			Fuzz_check(!memcmp(scratch, &model.data[offset < model.count ? offset : 0], peeked), "peek data");
+			break;
+		}
+		case 8: {
+			const uint16_t len = Fuzz_size(&input, capacity + 1);
+			const uint16_t skipped = CircularBuffer_skip(&buffer, len);
+			Fuzz_check(skipped == ((len < model.count) ? len : model.count), "skip size");
+			memmove(model.data, &model.data[skipped], model.count - skipped);
+			model.count -= skipped;
+			break;
+		}
+		case 9: {
+			// The span is the unread data up to the end of the memory.
+			const uint8_t * span = NULL;
+			const uint16_t spanLen = CircularBuffer_getFrontSpan(&buffer, &span);
+			Fuzz_check((spanLen <= model.count) && (!model.count || spanLen), "front span size");
+			Fuzz_check((spanLen == model.count) || (span + spanLen == memory + length), "front span cut short");
+			const uint16_t len = Fuzz_size(&input, spanLen);
+			if (spanLen) {
+				Fuzz_check((span >= memory) && (span + spanLen <= memory + length), "front span outside the memory");
+				Fuzz_modelPop(&model, span, len);
+				CircularBuffer_advanceFront(&buffer, len);
+			}
+			break;
+		}
+		case 10: {
+			uint8_t * span = NULL;
+			const uint16_t spanLen = CircularBuffer_getBackSpan(&buffer, &span);
+			Fuzz_check((spanLen <= free) && (!free || spanLen), "back span size");
+			const uint16_t len = Fuzz_size(&input, spanLen);
+			if (spanLen) {
+				Fuzz_check((span >= memory) && (span + spanLen <= memory + length), "back span outside the memory");
+				Fuzz_fill(&model, span, len);
+				Fuzz_modelPush(&model, span, len);
+				CircularBuffer_advanceBack(&buffer, len);
+			}
+			break;
+		}
+		case 11: {
+			const bool clear = Fuzz_byte(&input) & 1;
+			Fuzz_check(CircularBuffer_checkAndClearFault(&buffer, clear) == model.fault, "fault flag");
+			model.fault = false;
+			if (clear) {
+				model.count = 0;
+			}
+			break;
+		}
+		case 12: {
+			// Snapshot of the newest data that fits, restored in place or refused when truncated.
+			const uint16_t room = Fuzz_size(&input, capacity + 1);
+			const uint32_t len = CircularBuffer_snapshot(&buffer, scratch, sizeof(CircularBufferSnapshot_t) + room);
+			const uint16_t kept = (model.count < room) ? model.count : room;
+			Fuzz_check(len == sizeof(CircularBufferSnapshot_t) + kept, "snapshot size");
+			Fuzz_check(!memcmp(&scratch[sizeof(CircularBufferSnapshot_t)], &model.data[model.count - kept], kept), "snapshot data");
+			const uint8_t mode = Fuzz_byte(&input) % 3;
+			if (mode == 1) {
+				Fuzz_check(CircularBuffer_restore(&buffer, scratch, len), "restore refused");
+				memmove(model.data, &model.data[model.count - kept], kept);
+				model.count = kept;
+			} else if ((mode == 2) && kept) {
+				Fuzz_check(!CircularBuffer_restore(&buffer, scratch, len - 1), "truncated restore accepted");
+			}
+			break;
+		}
+		default:
+			Fuzz_check(CircularBuffer_getUnreadSize(&buffer) == model.count, "unread size");
+			break;
+		}
+
+		// Watermarks move at the thresholds only, and only the call that moved the data in that direction checks.
+		if (capacity && (model.count > before) && (model.count >= buffer.highWatermark)) {
+			model.high = true;
+		}
+		if (capacity && (model.count < before) && (model.count <= buffer.lowWatermark)) {
+			model.high = false;
+		}
+		Fuzz_check(reportedHigh == model.high, "watermark report");
+
+		// Whole state.
+		Fuzz_check(CircularBuffer_getUnreadSize(&buffer) == model.count, "unread size");
+		Fuzz_check(CircularBuffer_checkInvariants(&buffer), "invariants");
+		operation++;
+	}
+	free(memory);
+	return 0;
+}
+
+#if CIRCULARFUZZ_MAIN
+/*
+ * @brief Runs random inputs, or replays the files given, i.e. a crash saved by libFuzzer.
+ */
+int main(int argc, char * argv[]) {
+	static uint8_t data[FUZZ_MAX_INPUT];
+
+	// Replay.
+	FILE * const first = (argc > 1) ? fopen(argv[1], "rb") : NULL;
+	if (first) {
+		fclose(first);
+		for (int i = 1; i < argc; i++) {
+			FILE * const file = fopen(argv[i], "rb");
+			if (!file) {
+				printf("cannot open %s\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+			const size_t size = fread(data, 1, sizeof(data), file);
+			fclose(file);
+			LLVMFuzzerTestOneInput(data, size);
+		}
+		printf("PASS: %d inputs replayed\n", argc - 1);
+		return EXIT_SUCCESS;
+	}
+
+	// Random inputs.
+	const uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100000UL;
+	uint32_t state = 1;
+	uint64_t operations = 0;
+	for (uint32_t i = 0; i < iterations; i++) {
+		const size_t size = 1 + i % FUZZ_MAX_INPUT;
+		for (size_t j = 0; j < size; j++) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			data[j] = (uint8_t)state;
+		}
+		LLVMFuzzerTestOneInput(data, size);
+		operations += operation;
+	}
+	printf("PASS: %u inputs, %llu operations\n", iterations, (unsigned long long)operations);
+	return EXIT_SUCCESS;
+}
+#endif
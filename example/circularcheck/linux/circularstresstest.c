@@ -0,0 +1,280 @@
+/**
+ * @file      circularstresstest.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Multi-threaded stress test of the circular buffer, meant for ThreadSanitizer. A producer thread writes
+ *            sequence-numbered records through every push entry point and a consumer thread reads them back through
+ *            every pop entry point, checking each record, the fault handoff and the watermark reports. With
+ *            -DCIRCULARBUFFER_STATISTICS=1 the consumer also reads the counters while the producer updates them,
+ *            and -DCIRCULARBUFFER_DWELLTRACE=1 passes the dwell trace marks between the threads.
+ * @usage     gcc -O1 -g -fsanitize=thread -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularstresstest.c
+ *              ../../../circularbuffer.c -o circularstresstest
+ *            ./circularstresstest [records] [buffer length]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularbuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+// Settings.
+#define STRESS_HEADER_SIZE 5
+#define STRESS_MAX_PAYLOAD 64
+#define STRESS_MAX_LENGTH 4096
+#define STRESS_FAULT_PERIOD 97
+
+// Variables.
+static uint8_t memory[STRESS_MAX_LENGTH];
+static CircularBufferObject_t buffer;
+static uint32_t total;
+static uint32_t producerFaults, consumerFaults;
+static uint32_t highReports, lowReports;
+static bool reportedHigh;
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Stress_fail(const char * const message, const uint32_t sequence) {
+	if (!__atomic_exchange_n(&failed, true, __ATOMIC_RELAXED)) {
+		printf("FAIL: %s (record %u)\n", message, sequence);
+	}
+}
+
+/*
+ * @brief Checks whether a check failed on either thread.
+ */
+static bool Stress_failed(void) {
+	return __atomic_load_n(&failed, __ATOMIC_RELAXED);
+}
+
+/*
+ * @brief Builds a record: 4-byte sequence number, 1-byte payload size and a payload derived from the sequence number.
+ * @return Size of the record.
+ */
+static uint16_t Stress_record(const uint32_t sequence, uint8_t * const record) {
+	const uint8_t len = (uint8_t)((uint32_t)(sequence * 2654435761UL) >> 26);
+	memcpy(record, &sequence, sizeof(sequence));
+	record[4] = len;
+	for (uint8_t i = 0; i < len; i++) {
+		record[STRESS_HEADER_SIZE + i] = (uint8_t)(sequence * 31 + i);
+	}
+	return STRESS_HEADER_SIZE + len;
+}
+
+/*
+ * @brief Watermark callback, called from either thread. The reports of the two sides may interleave, the last one
+ *        must match the watermark state.
+ */
+static void Stress_watermark(CircularBufferObject_t * const bufferObject, const bool high) {
+	(void)bufferObject;
+	__atomic_fetch_add(high ? &highReports : &lowReports, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&reportedHigh, high, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * @brief Producer thread, pushes every record whole, rotating over the push entry points.
+ */
+static void * Stress_producer(void * const argument) {
+	uint8_t record[STRESS_HEADER_SIZE + STRESS_MAX_PAYLOAD];
+	(void)argument;
+
+	for (uint32_t sequence = 0; (sequence < total) && !Stress_failed(); sequence++) {
+		const uint16_t len = Stress_record(sequence, record);
+		uint16_t done = 0;
+		while ((done < len) && !Stress_failed()) {
+			uint16_t pushed = 0;
+			switch (sequence % 4) {
+			case 0:
+				// Byte by byte, a full buffer sets the fault.
+				if (CircularBuffer_pushBackByte(&buffer, record[done])) {
+					pushed = 1;
+				} else {
+					producerFaults++;
+				}
+				break;
+			case 1:
+				pushed = CircularBuffer_pushBack(&buffer, &record[done], len - done);
+				break;
+			case 2: {
+				// Header and payload as one vector, all or nothing.
+				const CircularBufferVector_t vector[2] = {{record, STRESS_HEADER_SIZE}, {&record[STRESS_HEADER_SIZE], (uint16_t)(len - STRESS_HEADER_SIZE)}};
+				pushed = CircularBuffer_pushBackV(&buffer, vector, 2, true);
+				if (pushed && (pushed != len)) {
+					Stress_fail("partial all-or-nothing push", sequence);
+				}
+				break;
+			}
+			default: {
+				// In place into the free span.
+				uint8_t * span;
+				pushed = CircularBuffer_getBackSpan(&buffer, &span);
+				if (pushed > len - done) {
+					pushed = len - done;
+				}
+				memcpy(span, &record[done], pushed);
+				CircularBuffer_advanceBack(&buffer, pushed);
+				break;
+			}
+			}
+			done += pushed;
+			if (!pushed) {
+				sched_yield();
+			}
+		}
+	}
+	return NULL;
+}
+
+/*
+ * @brief Pops a whole record, rotating over the pop entry points. The record must be unread in full.
+ */
+static void Stress_pop(const uint32_t sequence, uint8_t * const record, const uint16_t len) {
+	switch (sequence % 5) {
+	case 0:
+		for (uint16_t i = 0; i < len; i++) {
+			CircularBuffer_popFrontByte(&buffer, &record[i]);
+		}
+		break;
+	case 1:
+		CircularBuffer_popFront(&buffer, record, len);
+		break;
+	case 2: {
+		const CircularBufferVector_t vector[2] = {{record, STRESS_HEADER_SIZE}, {&record[STRESS_HEADER_SIZE], (uint16_t)(len - STRESS_HEADER_SIZE)}};
+		CircularBuffer_popFrontV(&buffer, vector, 2);
+		break;
+	}
+	case 3:
+		CircularBuffer_peek(&buffer, 0, record, len);
+		CircularBuffer_skip(&buffer, len);
+		break;
+	default:
+		// In place from the unread spans, in 1 or 2 parts.
+		for (uint16_t done = 0; done < len; ) {
+			const uint8_t * span;
+			uint16_t spanLen = CircularBuffer_getFrontSpan(&buffer, &span);
+			if (spanLen > len - done) {
+				spanLen = len - done;
+			}
+			memcpy(&record[done], span, spanLen);
+			CircularBuffer_advanceFront(&buffer, spanLen);
+			done += spanLen;
+		}
+		break;
+	}
+}
+
+/*
+ * @brief Consumer thread, waits for each record to be unread in full and checks it.
+ */
+static void * Stress_consumer(void * const argument) {
+	uint8_t record[STRESS_HEADER_SIZE + STRESS_MAX_PAYLOAD];
+	uint8_t expected[STRESS_HEADER_SIZE + STRESS_MAX_PAYLOAD];
+	(void)argument;
+
+	for (uint32_t sequence = 0; (sequence < total) && !Stress_failed(); ) {
+		// Header, then the whole record.
+		uint8_t payloadLen;
+		if (!CircularBuffer_peekAt(&buffer, 4, &payloadLen)
+			|| (CircularBuffer_getUnreadSize(&buffer) < STRESS_HEADER_SIZE + payloadLen)) {
+			sched_yield();
+			continue;
+		}
+		const uint16_t len = Stress_record(sequence, expected);
+		if (payloadLen != expected[4]) {
+			Stress_fail("record size out of sequence", sequence);
+			break;
+		}
+		Stress_pop(sequence, record, len);
+		if (memcmp(record, expected, len)) {
+			Stress_fail("record lost, repeated or corrupted", sequence);
+		}
+
+		// Take the faults now and then while the producer may be setting them.
+		if (!(sequence % STRESS_FAULT_PERIOD) && CircularBuffer_checkAndClearFault(&buffer, false)) {
+			consumerFaults++;
+		}
+#if CIRCULARBUFFER_STATISTICS
+		// Read the counters while the producer updates its own.
+		CircularBufferStatistics_t statistics;
+		CircularBuffer_getStatistics(&buffer, &statistics);
+		if (statistics.maxUnread > buffer.capacity) {
+			Stress_fail("maximum unread size above the capacity", sequence);
+		}
+#else
+		if (!CircularBuffer_checkInvariants(&buffer)) {
+			Stress_fail("invariants broken while running", sequence);
+		}
+#endif
+		sequence++;
+	}
+	return NULL;
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	total = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000UL;
+	const uint32_t length = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 263;
+	if ((length < STRESS_HEADER_SIZE + STRESS_MAX_PAYLOAD + 1) || (length > STRESS_MAX_LENGTH)) {
+		printf("buffer length must be %u to %u\n", STRESS_HEADER_SIZE + STRESS_MAX_PAYLOAD + 1, STRESS_MAX_LENGTH);
+		return EXIT_FAILURE;
+	}
+
+	// Watermarks at a quarter and three quarters.
+	CircularBuffer_initWithLength(&buffer, memory, length);
+	CircularBuffer_setWatermarks(&buffer, (uint16_t)(buffer.capacity * 3 / 4), (uint16_t)(buffer.capacity / 4), Stress_watermark);
+
+	// Run both sides.
+	pthread_t producer, consumer;
+	pthread_create(&consumer, NULL, Stress_consumer, NULL);
+	pthread_create(&producer, NULL, Stress_producer, NULL);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	// Every fault is reported, faults set before a check merge into one.
+	if (CircularBuffer_checkAndClearFault(&buffer, false)) {
+		consumerFaults++;
+	}
+	if ((consumerFaults > producerFaults) || (producerFaults && !consumerFaults)) {
+		Stress_fail("fault lost or reported twice", total);
+	}
+
+	// Drained, so the last report is the low edge.
+	if (CircularBuffer_getUnreadSize(&buffer) || !CircularBuffer_checkInvariants(&buffer)) {
+		Stress_fail("buffer not drained or inconsistent", total);
+	}
+	if (__atomic_load_n(&reportedHigh, __ATOMIC_SEQ_CST) || (highReports && !lowReports)) {
+		Stress_fail("last watermark report is not the low edge", total);
+	}
+
+	// Result.
+	if (!Stress_failed()) {
+		printf("PASS: %u records through a %u-byte buffer, %u faults set, %u reported, %u high and %u low reports\n",
+			total, length, producerFaults, consumerFaults, highReports, lowReports);
+	}
+	return Stress_failed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
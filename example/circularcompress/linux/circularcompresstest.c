@@ -0,0 +1,336 @@
+/**
+ * @file      circularcompresstest.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of circularcompress.c. A stream of text mixed with incompressible runs goes through three
+ *            rings whose lengths are not a power of 2, so blocks wrap, and must come out unchanged. Forged blocks
+ *            with a zero offset, an offset past the window, or literals and matches that run past the block must
+ *            set the fault without writing outside the dictionary, and the stream must restart after both sides
+ *            reset. Build with -fsanitize=address to catch accesses outside the state.
+ * @usage     gcc -O1 -g -fsanitize=address,undefined -I../../.. circularcompresstest.c ../../../circularcompress.c
+ *              ../../../circularbuffer.c -o circularcompresstest
+ *            ./circularcompresstest [stream length]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularcompress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Settings.
+#define TEST_INPUT_LENGTH 3001
+#define TEST_CHANNEL_LENGTH 1499
+#define TEST_OUTPUT_LENGTH 4999
+#define TEST_MAX_STEP 700
+
+// Variables.
+static CircularCompress_t compressor, decompressor;
+static uint8_t inputMemory[TEST_INPUT_LENGTH];
+static uint8_t channelMemory[TEST_CHANNEL_LENGTH];
+static uint8_t outputMemory[TEST_OUTPUT_LENGTH];
+static CircularBufferObject_t input, channel, output;
+static uint8_t * source;
+static uint32_t sourceLen;
+static uint32_t compressedBlocks, storedBlocks, wrappedBlocks, forgedBlocks;
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message, const uint32_t position) {
+	if (!failed) {
+		printf("FAIL: %s (at %u)\n", message, position);
+	}
+	failed = true;
+}
+
+/*
+ * @brief Fills the source stream with telemetry-like text, random bytes in between and now and then a run of
+ *        random bytes that does not compress.
+ */
+static void Test_source(void) {
+	static const char * const words[] = {"temperature=", "23.5;", "humidity=", "41%;", "\n", "ok ", "sensor#7 "};
+	for (uint32_t i = 0; i < sourceLen; ) {
+		if (!(rand() % 200)) {
+			for (uint32_t run = 1000 + rand() % 3000; run-- && (i < sourceLen); ) {
+				source[i++] = (uint8_t)rand();
+			}
+		} else if (!(rand() % 5)) {
+			source[i++] = (uint8_t)rand();
+		} else {
+			for (const char * word = words[rand() % 7]; *word && (i < sourceLen); word++) {
+				source[i++] = (uint8_t)*word;
+			}
+		}
+	}
+}
+
+/*
+ * @brief Empties a buffer and moves its pointers to the given position.
+ */
+static void Test_moveTo(CircularBufferObject_t * const bufferObject, const uint16_t position) {
+	static const uint8_t filler[64];
+	CircularBuffer_skip(bufferObject, CircularBuffer_getUnreadSize(bufferObject));
+	while (bufferObject->back != position) {
+		uint16_t step = (uint16_t)((position + bufferObject->length - bufferObject->back) % bufferObject->length);
+		if (step > sizeof(filler)) {
+			step = sizeof(filler);
+		}
+		CircularBuffer_pushBack(bufferObject, filler, step);
+		CircularBuffer_skip(bufferObject, step);
+	}
+}
+
+/*
+ * @brief Streams the source from the given position through the compressor, the channel and the decompressor in
+ *        random steps, and checks the output against it.
+ * @return Returns the number of bytes streamed.
+ */
+static uint32_t Test_stream(const uint32_t from, const uint32_t len) {
+	uint8_t data[TEST_MAX_STEP];
+	uint32_t pushed = 0, popped = 0;
+
+	while ((popped < len) && !failed) {
+		// Feed a random step.
+		uint16_t step = (uint16_t)(rand() % TEST_MAX_STEP);
+		if (step > len - pushed) {
+			step = (uint16_t)(len - pushed);
+		}
+		pushed += CircularBuffer_pushBack(&input, &source[from + pushed], step);
+
+		// Compress one block and note its kind from the header.
+		const uint16_t unread = CircularBuffer_getUnreadSize(&channel);
+		const uint16_t back = channel.back;
+		const uint16_t raw = CircularCompress_compress(&compressor, &input, &channel);
+		if (raw) {
+			uint8_t header[CIRCULARCOMPRESS_HEADER_SIZE];
+			CircularBuffer_peek(&channel, unread, header, sizeof(header));
+			const uint16_t compressedLen = header[2] | ((uint16_t)header[3] << 8);
+			if (((header[0] | ((uint16_t)header[1] << 8)) != raw) || (compressedLen > raw)) {
+				Test_fail("block header does not match the block", from + popped);
+			}
+			if (compressedLen < raw) {
+				compressedBlocks++;
+			} else {
+				storedBlocks++;
+			}
+			if ((uint32_t)back + CIRCULARCOMPRESS_HEADER_SIZE + compressedLen > channel.length) {
+				wrappedBlocks++;
+			}
+		}
+
+		// Decompress the whole blocks and check a random step of the output.
+		while (CircularCompress_decompress(&decompressor, &channel, &output)) {
+		}
+		const uint16_t got = CircularBuffer_popFront(&output, data, (uint16_t)(rand() % TEST_MAX_STEP));
+		if (memcmp(data, &source[from + popped], got)) {
+			Test_fail("output differs from the stream", from + popped);
+		}
+		popped += got;
+		if (CircularCompress_checkAndClearFault(&decompressor, false)) {
+			Test_fail("fault on a valid block", from + popped);
+		}
+	}
+	return popped;
+}
+
+/*
+ * @brief Resets both sides, as after a fault, and primes the dictionaries with a full window of the stream.
+ */
+static void Test_reset(void) {
+	CircularCompress_init(&compressor);
+	CircularCompress_init(&decompressor);
+	CircularBuffer_skip(&input, CircularBuffer_getUnreadSize(&input));
+	CircularBuffer_skip(&output, CircularBuffer_getUnreadSize(&output));
+	Test_stream(0, CIRCULARCOMPRESS_WINDOW + 1000);
+	if (decompressor.historyLen != CIRCULARCOMPRESS_WINDOW) {
+		Test_fail("dictionary not full after priming", 0);
+	}
+}
+
+/*
+ * @brief Decompresses a forged block, once ending at the end of the channel memory so that it is decoded in place
+ *        and once across the end through the scratch memory. It must be dropped with the fault set, produce no
+ *        output and write nothing past its raw size.
+ */
+static void Test_forged(const char * const message, const uint16_t len, const uint8_t * const sequences, const uint16_t sequencesLen) {
+	const uint8_t header[CIRCULARCOMPRESS_HEADER_SIZE] = {(uint8_t)len, (uint8_t)(len >> 8), (uint8_t)sequencesLen, (uint8_t)(sequencesLen >> 8)};
+	const uint16_t guarded = (len < CIRCULARCOMPRESS_BLOCK) ? len : CIRCULARCOMPRESS_BLOCK;
+
+	for (uint16_t wrapped = 0; wrapped < 2; wrapped++) {
+		// Guard the dictionary after the raw size, and the scratch memory when it is not used.
+		Test_reset();
+		const uint32_t position = decompressor.position;
+		memset(&decompressor.history[CIRCULARCOMPRESS_WINDOW + guarded], 0xA5, CIRCULARCOMPRESS_BLOCK - guarded);
+		memset(decompressor.scratch, 0xA5, sizeof(decompressor.scratch));
+		Test_moveTo(&channel, (uint16_t)(channel.length - (wrapped ? 3 : CIRCULARCOMPRESS_HEADER_SIZE + sequencesLen)));
+		CircularBuffer_pushBack(&channel, header, sizeof(header));
+		CircularBuffer_pushBack(&channel, sequences, sequencesLen);
+		if (CircularCompress_decompress(&decompressor, &channel, &output) || CircularBuffer_getUnreadSize(&output)
+			|| CircularBuffer_getUnreadSize(&channel) || (decompressor.historyLen != CIRCULARCOMPRESS_WINDOW)) {
+			Test_fail(message, position);
+		}
+		for (uint32_t i = CIRCULARCOMPRESS_WINDOW + guarded; i < sizeof(decompressor.history); i++) {
+			if (decompressor.history[i] != 0xA5) {
+				Test_fail("written past the raw size", position);
+				break;
+			}
+		}
+		for (uint32_t i = 0; !wrapped && (i < sizeof(decompressor.scratch)); i++) {
+			if (decompressor.scratch[i] != 0xA5) {
+				Test_fail("written past the dictionary", position);
+				break;
+			}
+		}
+		if (!CircularCompress_checkAndClearFault(&decompressor, false) || CircularCompress_checkAndClearFault(&decompressor, false)) {
+			Test_fail("fault not reported once", position);
+		}
+		forgedBlocks++;
+	}
+}
+
+/*
+ * @brief Feeds forged blocks, each one after a full window of valid stream.
+ */
+static void Test_corrupt(void) {
+	// Zero offset.
+	const uint8_t zeroOffset[] = {0x10, 'a', 0x00, 0x00};
+	Test_forged("zero offset not rejected", 5, zeroOffset, sizeof(zeroOffset));
+
+	// One byte past the window, with the dictionary full.
+	const uint16_t far = CIRCULARCOMPRESS_WINDOW + 2;
+	const uint8_t pastWindow[] = {0x10, 'a', (uint8_t)far, (uint8_t)(far >> 8)};
+	Test_forged("offset past the window not rejected", 5, pastWindow, sizeof(pastWindow));
+
+	// Past the start of the stream, with an empty dictionary.
+	const uint8_t pastStart[] = {0x10, 'a', 0x02, 0x00};
+	CircularCompress_init(&decompressor);
+	Test_moveTo(&channel, (uint16_t)(channel.length - 3));
+	const uint8_t pastStartHeader[] = {5, 0, sizeof(pastStart), 0};
+	CircularBuffer_pushBack(&channel, pastStartHeader, sizeof(pastStartHeader));
+	CircularBuffer_pushBack(&channel, pastStart, sizeof(pastStart));
+	if (CircularCompress_decompress(&decompressor, &channel, &output) || !CircularCompress_checkAndClearFault(&decompressor, true)) {
+		Test_fail("offset past the start of the stream not rejected", 0);
+	}
+
+	// Literals past the end of the block data, and past the raw size after a long match.
+	const uint8_t literalsPastData[] = {0xA0, 'a', 'b', 'c'};
+	Test_forged("literals past the block data not rejected", 10, literalsPastData, sizeof(literalsPastData));
+	const uint8_t literalsPastRaw[] = {0x1F, 'a', 0x01, 0x00, 20, 0x30, 'b', 'c', 'd'};
+	Test_forged("literals past the raw size not rejected", 41, literalsPastRaw, sizeof(literalsPastRaw));
+
+	// Match past the raw size, and a length extension cut by the end of the block.
+	const uint8_t matchPastRaw[] = {0x1F, 'a', 0x01, 0x00, 20};
+	Test_forged("match past the raw size not rejected", 10, matchPastRaw, sizeof(matchPastRaw));
+	const uint8_t cutExtension[] = {0xF0, 255};
+	Test_forged("cut length extension not rejected", 300, cutExtension, sizeof(cutExtension));
+	const uint8_t cutOffset[] = {0x10, 'a', 0x01};
+	Test_forged("cut match offset not rejected", 5, cutOffset, sizeof(cutOffset));
+
+	// Block data that ends before the raw size, and sizes the header cannot have.
+	const uint8_t shortData[] = {0x20, 'a', 'b'};
+	Test_forged("block shorter than its raw size not rejected", 5, shortData, sizeof(shortData));
+	Test_forged("compressed size above the raw size not rejected", 2, shortData, sizeof(shortData));
+	// A match of the block size after a literal, the token nibble and the minimum match are not in the extension.
+	uint8_t longMatch[21] = {0x1F, 'a', 0x01, 0x00};
+	uint32_t extension = CIRCULARCOMPRESS_BLOCK - 15 - 4;
+	uint16_t longMatchLen = 4;
+	for (; extension >= 255; extension -= 255) {
+		longMatch[longMatchLen++] = 255;
+	}
+	longMatch[longMatchLen++] = (uint8_t)extension;
+	Test_forged("raw size above the block size not rejected", CIRCULARCOMPRESS_BLOCK + 1, longMatch, longMatchLen);
+
+	// The farthest offset is valid and copies the oldest byte of the window.
+	Test_reset();
+	const uint32_t streamed = CIRCULARCOMPRESS_WINDOW + 1000;
+	const uint16_t farthest = CIRCULARCOMPRESS_WINDOW + 1;
+	const uint8_t header[] = {5, 0, 4, 0};
+	const uint8_t farthestMatch[] = {0x10, 'a', (uint8_t)farthest, (uint8_t)(farthest >> 8)};
+	uint8_t data[5];
+	CircularBuffer_pushBack(&channel, header, sizeof(header));
+	CircularBuffer_pushBack(&channel, farthestMatch, sizeof(farthestMatch));
+	if ((CircularCompress_decompress(&decompressor, &channel, &output) != 5) || (CircularBuffer_popFront(&output, data, 5) != 5)
+		|| (data[0] != 'a') || memcmp(&data[1], &source[streamed - CIRCULARCOMPRESS_WINDOW], 4)
+		|| CircularCompress_checkAndClearFault(&decompressor, false)) {
+		Test_fail("farthest offset not decoded", streamed);
+	}
+
+	// The nearest offset repeats the newest byte of the window.
+	const uint8_t newest[4] = {data[4], data[4], data[4], data[4]};
+	const uint8_t nearestMatch[] = {0x00, 0x01, 0x00};
+	const uint8_t nearestHeader[] = {4, 0, 3, 0};
+	CircularBuffer_pushBack(&channel, nearestHeader, sizeof(nearestHeader));
+	CircularBuffer_pushBack(&channel, nearestMatch, sizeof(nearestMatch));
+	if ((CircularCompress_decompress(&decompressor, &channel, &output) != 4) || (CircularBuffer_popFront(&output, data, 4) != 4)
+		|| memcmp(data, newest, 4) || CircularCompress_checkAndClearFault(&decompressor, false)) {
+		Test_fail("nearest offset not decoded", streamed);
+	}
+
+	// Both sides reset, the stream continues.
+	CircularCompress_checkAndClearFault(&compressor, true);
+	CircularCompress_checkAndClearFault(&decompressor, true);
+	Test_stream(0, 100000);
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	sourceLen = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000UL;
+	if (sourceLen < 100000) {
+		sourceLen = 100000;
+	}
+	source = malloc(sourceLen);
+	if (!source) {
+		return EXIT_FAILURE;
+	}
+
+	// Rings that are not a power of 2.
+	srand(1);
+	Test_source();
+	CircularBuffer_initWithLength(&input, inputMemory, sizeof(inputMemory));
+	CircularBuffer_initWithLength(&channel, channelMemory, sizeof(channelMemory));
+	CircularBuffer_initWithLength(&output, outputMemory, sizeof(outputMemory));
+	CircularCompress_init(&compressor);
+	CircularCompress_init(&decompressor);
+
+	// The whole stream, then the forged blocks.
+	if (Test_stream(0, sourceLen) != sourceLen) {
+		Test_fail("stream incomplete", sourceLen);
+	}
+	if (!compressedBlocks || !storedBlocks || !wrappedBlocks) {
+		Test_fail("compressed, stored or wrapped blocks missing", sourceLen);
+	}
+	Test_corrupt();
+
+	// Result.
+	if (!failed) {
+		printf("PASS: %u bytes in %u compressed and %u stored blocks, %u wrapped, %u forged blocks rejected\n",
+			sourceLen, compressedBlocks, storedBlocks, wrappedBlocks, forgedBlocks);
+	}
+	free(source);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
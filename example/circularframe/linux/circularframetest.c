@@ -0,0 +1,531 @@
+/**
+ * @file      circularframetest.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of circularframe.c. Random payloads, dense with the special bytes of every codec, are encoded
+ *            and decoded across the end of a ring whose length is not a power of 2 and checked byte by byte, and
+ *            known vectors and an exact fit check the encoders. Truncated, oversized and otherwise damaged frames must be discarded
+ *            and counted without losing the next frame. Frames also go through CircularUART_SendFrame() and a
+ *            simulated tx DMA channel into the rx buffer, as on the wire.
+ * @usage     gcc -O2 -I../../circularuart/linux -I../../circularuart/stm32f10x -I../../.. -DCIRCULARUART_TX_DMA=1
+ *              -DCIRCULARUART_VECTORS=0 circularframetest.c ../../circularuart/stm32f10x/circularuart.c
+ *              ../../../circularframe.c ../../../circularbuffer.c -o circularframetest
+ *            ./circularframetest [frames]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularframe.h"
+#include "circularuart.h"
+#include <stm32f10x.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Settings.
+#define TEST_RING_LENGTH 1021
+#define TEST_MAX_PAYLOAD 300
+#define TEST_QUEUE_LENGTH 8
+#define TEST_TX_LENGTH_2N 8
+#define TEST_RX_LENGTH_2N 9
+#define TEST_UART_PAYLOAD 100
+#define TEST_DAMAGED_LENGTH 40
+
+// Peripherals.
+USART_TypeDef FakeUSART[5];
+DMA_Channel_TypeDef FakeDMAChannel[4];
+GPIO_TypeDef FakeGPIO[4];
+
+// Variables.
+static const char * const codecNames[] = {"COBS", "SLIP", "HDLC"};
+static const uint8_t delimiters[] = {0x00, 0xC0, 0x7E};
+static uint8_t ringMemory[TEST_RING_LENGTH];
+static uint8_t scratchMemory[TEST_RING_LENGTH];
+static CircularBufferObject_t ring, scratch;
+static CircularUART_t uart;
+static uint8_t txMemory[1UL << TEST_TX_LENGTH_2N];
+static uint8_t rxMemory[1UL << TEST_RX_LENGTH_2N];
+static uint32_t pendingComplete;
+static uint32_t dmaDone;
+static uint32_t frameCount, wrapCount, discardCount;
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message, const CircularFrameCodec_t codec) {
+	if (!failed) {
+		printf("FAIL: %s (%s, frame %u)\n", message, codecNames[codec], frameCount);
+	}
+	failed = true;
+}
+
+/*
+ * @brief Fills a random payload, by turns plain, dense with the special bytes of every codec, or without zeros so
+ *        that COBS blocks reach their full length. Lengths at the COBS block boundaries are picked more often.
+ */
+static uint16_t Test_payload(uint8_t * const data, const uint16_t minlen, const uint16_t maxlen) {
+	static const uint8_t special[] = {0x00, 0x7E, 0x7D, 0x5E, 0x5D, 0xC0, 0xDB, 0xDC, 0xDD};
+	static const uint16_t boundaries[] = {0, 1, 253, 254, 255, 256};
+	uint16_t len = (uint16_t)(minlen + rand() % (maxlen - minlen + 1));
+	if (!(rand() % 8) && (boundaries[len % 6] >= minlen) && (boundaries[len % 6] <= maxlen)) {
+		len = boundaries[len % 6];
+	}
+	const int kind = rand() % 4;
+	for (uint16_t i = 0; i < len; i++) {
+		if (kind == 0) {
+			data[i] = (uint8_t)rand();
+		} else if (kind == 1) {
+			data[i] = special[rand() % sizeof(special)];
+		} else if (kind == 2) {
+			data[i] = (rand() % 4) ? (uint8_t)rand() : special[rand() % sizeof(special)];
+		} else {
+			data[i] = (uint8_t)(1 + rand() % 255);
+		}
+	}
+	return len;
+}
+
+/*
+ * @brief Empties a buffer and moves its pointers to the given position.
+ */
+static void Test_moveTo(CircularBufferObject_t * const bufferObject, const uint16_t position) {
+	static const uint8_t filler[64];
+	CircularBuffer_skip(bufferObject, CircularBuffer_getUnreadSize(bufferObject));
+	while (bufferObject->back != position) {
+		uint16_t step = (uint16_t)((position + bufferObject->length - bufferObject->back) % bufferObject->length);
+		if (step > sizeof(filler)) {
+			step = sizeof(filler);
+		}
+		CircularBuffer_pushBack(bufferObject, filler, step);
+		CircularBuffer_skip(bufferObject, step);
+	}
+}
+
+/*
+ * @brief Checks that an encoded frame has the delimiter only at its end, and for SLIP and HDLC also at its start.
+ */
+static void Test_checkDelimiters(const CircularBufferObject_t * const bufferObject, const CircularFrameCodec_t codec, const uint16_t from, const uint16_t len) {
+	for (uint16_t i = 0; i < len; i++) {
+		uint8_t data = 0;
+		CircularBuffer_peekAt(bufferObject, from + i, &data);
+		const bool edge = (i == len - 1) || (!i && (codec != CircularFrame_COBS));
+		if ((data == delimiters[codec]) != edge) {
+			Test_fail("delimiter misplaced in the encoded frame", codec);
+			return;
+		}
+	}
+}
+
+/*
+ * @brief Encodes a payload through the scratch buffer into linear memory.
+ */
+static uint16_t Test_encode(const CircularFrameCodec_t codec, const uint8_t * const data, const uint16_t len, uint8_t * const encoded) {
+	const uint16_t encodedLen = CircularFrame_encode(&scratch, codec, data, len);
+	CircularBuffer_popFront(&scratch, encoded, encodedLen);
+	return encodedLen;
+}
+
+/*
+ * @brief Checks the encoders against known frames, written across the end of the ring.
+ */
+static void Test_vectors(void) {
+	static const uint8_t cobsPayload[] = {0x11, 0x22, 0x00, 0x33};
+	static const uint8_t cobsFrame[] = {0x03, 0x11, 0x22, 0x02, 0x33, 0x00};
+	static const uint8_t slipPayload[] = {0x01, 0xC0, 0xDB, 0x02};
+	static const uint8_t slipFrame[] = {0xC0, 0x01, 0xDB, 0xDC, 0xDB, 0xDD, 0x02, 0xC0};
+	static const uint8_t hdlcPayload[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+	static const uint8_t hdlcFrame[] = {0x7E, '1', '2', '3', '4', '5', '6', '7', '8', '9', 0x6E, 0x90, 0x7E};
+	static const uint8_t hdlcEscapedPayload[] = {0x7E, 0x1C};
+	static const uint8_t hdlcEscapedFrame[] = {0x7E, 0x7D, 0x5E, 0x1C, 0x7D, 0x5E, 0xBF, 0x7E};
+	static const struct{
+		CircularFrameCodec_t codec;
+		const uint8_t * payload;
+		uint16_t payloadLen;
+		const uint8_t * frame;
+		uint16_t frameLen;
+	}vectors[] = {
+		{CircularFrame_COBS, cobsPayload, sizeof(cobsPayload), cobsFrame, sizeof(cobsFrame)},
+		{CircularFrame_SLIP, slipPayload, sizeof(slipPayload), slipFrame, sizeof(slipFrame)},
+		{CircularFrame_HDLC, hdlcPayload, sizeof(hdlcPayload), hdlcFrame, sizeof(hdlcFrame)},
+		{CircularFrame_HDLC, hdlcEscapedPayload, sizeof(hdlcEscapedPayload), hdlcEscapedFrame, sizeof(hdlcEscapedFrame)}
+	};
+	uint8_t encoded[16];
+
+	for (uint16_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		Test_moveTo(&ring, (uint16_t)(ring.length - 3));
+		const uint16_t encodedLen = CircularFrame_encode(&ring, vectors[i].codec, vectors[i].payload, vectors[i].payloadLen);
+		if ((encodedLen != vectors[i].frameLen) || (CircularBuffer_popFront(&ring, encoded, sizeof(encoded)) != encodedLen)
+			|| memcmp(encoded, vectors[i].frame, encodedLen)) {
+			Test_fail("encoded frame differs from the known one", vectors[i].codec);
+		}
+	}
+
+	// A full COBS block at the end of the payload needs no empty block after it.
+	uint8_t block[254];
+	memset(block, 0x01, sizeof(block));
+	if (CircularFrame_encode(&ring, CircularFrame_COBS, block, sizeof(block)) != sizeof(block) + 2) {
+		Test_fail("full block not encoded as one block", CircularFrame_COBS);
+	}
+	CircularBuffer_skip(&ring, CircularBuffer_getUnreadSize(&ring));
+}
+
+/*
+ * @brief Encodes a frame into exactly the free space it needs, and fails with one byte less.
+ */
+static void Test_fit(const CircularFrameCodec_t codec) {
+	static const uint8_t payload[] = {0x7E, 0x00, 0xC0, 0x31, 0x7D, 0xDB};
+	uint8_t encoded[2 * sizeof(payload) + 6];
+	const uint16_t encodedLen = Test_encode(codec, payload, sizeof(payload), encoded);
+
+	Test_moveTo(&ring, (uint16_t)(ring.length - 4));
+	for (uint16_t i = 0; i < ring.capacity - encodedLen + 1; i++) {
+		CircularBuffer_pushBackByte(&ring, 0x31);
+	}
+	const uint16_t unread = CircularBuffer_getUnreadSize(&ring);
+	if (CircularFrame_encode(&ring, codec, payload, sizeof(payload)) || (CircularBuffer_getUnreadSize(&ring) != unread)) {
+		Test_fail("frame pushed into one byte too little", codec);
+	}
+	CircularBuffer_skip(&ring, 1);
+	if ((CircularFrame_encode(&ring, codec, payload, sizeof(payload)) != encodedLen) || (CircularBuffer_getUnreadSize(&ring) != ring.capacity)
+		|| (CircularBuffer_peek(&ring, unread - 1, encoded, encodedLen) != encodedLen) || (encoded[encodedLen - 1] != delimiters[codec])) {
+		Test_fail("frame not pushed into the exact space", codec);
+	}
+	CircularBuffer_skip(&ring, CircularBuffer_getUnreadSize(&ring));
+}
+
+/*
+ * @brief Encodes batches of random frames until one does not fit, then decodes and checks them in order.
+ */
+static void Test_roundTrip(const CircularFrameCodec_t codec, const uint32_t frames) {
+	static uint8_t sent[TEST_QUEUE_LENGTH][TEST_MAX_PAYLOAD];
+	uint16_t sentLen[TEST_QUEUE_LENGTH];
+	uint8_t data[TEST_MAX_PAYLOAD + 2];
+	CircularFrameDecoder_t decoder;
+
+	CircularFrame_initDecoder(&decoder, &ring, codec);
+	for (uint32_t done = 0; (done < frames) && !failed; ) {
+		// SLIP cannot carry an empty frame. A frame that does not fit must push nothing.
+		uint16_t queued = 0;
+		while (queued < TEST_QUEUE_LENGTH) {
+			sentLen[queued] = Test_payload(sent[queued], codec == CircularFrame_SLIP, TEST_MAX_PAYLOAD);
+			const uint16_t unread = CircularBuffer_getUnreadSize(&ring);
+			const uint16_t back = ring.back;
+			const uint16_t encodedLen = CircularFrame_encode(&ring, codec, sent[queued], sentLen[queued]);
+			if (!encodedLen) {
+				if (CircularBuffer_getUnreadSize(&ring) != unread) {
+					Test_fail("frame that did not fit was pushed", codec);
+				}
+				break;
+			}
+			if ((uint32_t)back + encodedLen > ring.length) {
+				wrapCount++;
+			}
+			Test_checkDelimiters(&ring, codec, unread, encodedLen);
+			queued++;
+		}
+
+		// Decode in order.
+		for (uint16_t i = 0; i < queued; i++) {
+			uint16_t len = 0;
+			if (!CircularFrame_decode(&decoder, data, sizeof(data), &len) || (len != sentLen[i]) || memcmp(data, sent[i], len)) {
+				Test_fail("frame lost or corrupted", codec);
+			}
+			frameCount++;
+			done++;
+		}
+		uint16_t len;
+		if (CircularFrame_decode(&decoder, data, sizeof(data), &len) || CircularBuffer_getUnreadSize(&ring) || decoder.discardedFrames) {
+			Test_fail("extra or discarded frame after the batch", codec);
+		}
+	}
+}
+
+/*
+ * @brief Pushes a damaged frame across the end of the ring, then a valid one. The damaged frame must be discarded and
+ *        counted, and the valid one decoded.
+ */
+static void Test_discard(const CircularFrameCodec_t codec, const char * const message, const uint8_t * const damaged, const uint16_t damagedLen, const uint16_t maxlen) {
+	static const uint8_t payload[] = {0x01, 0x7E, 0x00, 0xC0, 0x7D, 0xDB, 0x02};
+	uint8_t data[TEST_DAMAGED_LENGTH + 2];
+	uint16_t len = 0;
+	CircularFrameDecoder_t decoder;
+
+	Test_moveTo(&ring, (uint16_t)(ring.length - damagedLen / 2));
+	CircularFrame_initDecoder(&decoder, &ring, codec);
+	CircularBuffer_pushBack(&ring, damaged, damagedLen);
+	CircularFrame_encode(&ring, codec, payload, sizeof(payload));
+	if (!CircularFrame_decode(&decoder, data, maxlen, &len) || (len != sizeof(payload)) || memcmp(data, payload, len)
+		|| (decoder.discardedFrames != 1) || CircularBuffer_getUnreadSize(&ring)) {
+		Test_fail(message, codec);
+	}
+	discardCount += decoder.discardedFrames;
+}
+
+/*
+ * @brief Feeds truncated, oversized and damaged frames of a codec.
+ */
+static void Test_damaged(const CircularFrameCodec_t codec) {
+	uint8_t payload[TEST_DAMAGED_LENGTH], damaged[2 * TEST_DAMAGED_LENGTH + 4];
+	uint8_t data[TEST_DAMAGED_LENGTH + 2];
+	uint16_t len;
+
+	// Truncated, the byte before the final delimiter is lost. COBS misses a block byte, SLIP and HDLC end in an
+	// escape, as the payload ends in both escaped bytes.
+	for (uint16_t i = 0; i < 10; i++) {
+		payload[i] = (uint8_t)(0x31 + i);
+	}
+	payload[10] = 0x7E;
+	payload[11] = 0xC0;
+	len = Test_encode(codec, payload, 12, damaged);
+	damaged[len - 2] = damaged[len - 1];
+	Test_discard(codec, "truncated frame not discarded", damaged, (uint16_t)(len - 1), sizeof(data));
+
+	// Oversized, one byte more than the output memory holds.
+	for (uint16_t i = 0; i < TEST_DAMAGED_LENGTH; i++) {
+		payload[i] = (uint8_t)(0x41 + i);
+	}
+	const uint16_t maxlen = (codec == CircularFrame_HDLC) ? TEST_DAMAGED_LENGTH + 1 : TEST_DAMAGED_LENGTH - 1;
+	len = Test_encode(codec, payload, TEST_DAMAGED_LENGTH, damaged);
+	Test_discard(codec, "oversized frame not discarded", damaged, len, maxlen);
+
+	// Damaged, an HDLC payload bit flips, a SLIP escape is invalid, a COBS block runs past the frame.
+	len = Test_encode(codec, payload, 10, damaged);
+	if (codec == CircularFrame_HDLC) {
+		damaged[4] ^= 0x01;
+	} else if (codec == CircularFrame_SLIP) {
+		damaged[4] = 0xDB;
+	} else {
+		damaged[0]++;
+	}
+	Test_discard(codec, (codec == CircularFrame_HDLC) ? "frame with a bad FCS not discarded" : "invalid frame not discarded", damaged, len, sizeof(data));
+
+	// Too short to carry an HDLC FCS, a SLIP escape cut by the delimiter, a COBS run of more than one block.
+	if (codec == CircularFrame_HDLC) {
+		const uint8_t shortFrame[] = {0x7E, 0x31, 0x7E};
+		Test_discard(codec, "frame without an FCS not discarded", shortFrame, sizeof(shortFrame), sizeof(data));
+	} else if (codec == CircularFrame_SLIP) {
+		const uint8_t shortFrame[] = {0xC0, 0x31, 0xDB, 0xC0};
+		Test_discard(codec, "frame ending in an escape not discarded", shortFrame, sizeof(shortFrame), sizeof(data));
+	} else {
+		const uint8_t shortFrame[] = {0xFF, 0x31, 0x00};
+		Test_discard(codec, "frame with a long block not discarded", shortFrame, sizeof(shortFrame), sizeof(data));
+	}
+
+	// Noise without a delimiter fills the buffer, it is dropped and the next frame is found.
+	CircularFrameDecoder_t decoder;
+	CircularFrame_initDecoder(&decoder, &ring, codec);
+	Test_moveTo(&ring, (uint16_t)(ring.length / 2));
+	for (uint16_t i = 0; i < ring.capacity; i++) {
+		CircularBuffer_pushBackByte(&ring, (uint8_t)(0x80 + i % 0x3D));
+	}
+	if (CircularFrame_decode(&decoder, data, sizeof(data), &len) || CircularBuffer_getUnreadSize(&ring) || (decoder.discardedFrames != 1)) {
+		Test_fail("full buffer without a delimiter not dropped", codec);
+	}
+	discardCount += decoder.discardedFrames;
+
+	// Split delivery, the first part is scanned once and the frame completes with the rest.
+	len = Test_encode(codec, payload, 10, damaged);
+	CircularBuffer_pushBack(&ring, damaged, len / 2);
+	uint16_t decodedLen = 0;
+	if (CircularFrame_decode(&decoder, data, sizeof(data), &decodedLen)) {
+		Test_fail("partial frame decoded", codec);
+	}
+	CircularBuffer_pushBack(&ring, &damaged[len / 2], (uint16_t)(len - len / 2));
+	if (!CircularFrame_decode(&decoder, data, sizeof(data), &decodedLen) || (decodedLen != 10) || memcmp(data, payload, 10)) {
+		Test_fail("frame delivered in two parts lost", codec);
+	}
+
+	// The partly scanned data is cleared behind the decoder, i.e. on a line reset, and a shorter frame follows.
+	CircularBuffer_pushBack(&ring, damaged, (uint16_t)(len - 1));
+	if (CircularFrame_decode(&decoder, data, sizeof(data), &decodedLen)) {
+		Test_fail("partial frame decoded", codec);
+	}
+	CircularBuffer_checkAndClearFault(&ring, true);
+	len = Test_encode(codec, payload, 2, damaged);
+	CircularBuffer_pushBack(&ring, damaged, len);
+	if (!CircularFrame_decode(&decoder, data, sizeof(data), &decodedLen) || (decodedLen != 2) || memcmp(data, payload, 2)) {
+		Test_fail("frame after a cleared buffer lost", codec);
+	}
+}
+
+/*
+ * @brief Moves up to maxlen bytes through the enabled channel of USART2 into the rx buffer, as if the line looped
+ *        back, and raises transfer-complete at the end.
+ */
+static void Test_runDma(uint32_t maxlen) {
+	DMA_Channel_TypeDef * const channel = DMA1_Channel7;
+
+	// Idle or already complete.
+	if (!(channel->CCR & DMA_CCR1_EN) || !channel->CNDTR) {
+		return;
+	}
+
+	// Move bytes to the line.
+	const uint8_t * const memory = (const uint8_t *)(((uintptr_t)txMemory & ~(uintptr_t)0xFFFFFFFFUL) | channel->CMAR);
+	while (maxlen-- && channel->CNDTR) {
+		if (!CircularBuffer_pushBackByte(&uart.rxBufferObject, memory[dmaDone++])) {
+			Test_fail("rx buffer overflow", CircularFrame_COBS);
+		}
+		channel->CNDTR--;
+	}
+
+	// Transfer complete.
+	if (!channel->CNDTR) {
+		pendingComplete |= DMA1_IT_TC7;
+		CircularUART_DMAIRQHandler(&uart);
+	}
+}
+
+/*
+ * @brief Sends random frames with CircularUART_SendFrame() while the DMA moves them in random steps, and decodes them
+ *        from the rx buffer in order.
+ */
+static void Test_uart(const CircularFrameCodec_t codec, const uint32_t frames) {
+	static uint8_t sent[TEST_QUEUE_LENGTH][TEST_UART_PAYLOAD];
+	uint16_t sentLen[TEST_QUEUE_LENGTH];
+	uint8_t data[TEST_UART_PAYLOAD + 2];
+	uint32_t head = 0, tail = 0;
+	bool pending = false;
+	CircularFrameDecoder_t decoder;
+
+	CircularFrame_initDecoder(&decoder, &uart.rxBufferObject, codec);
+	for (uint32_t stalls = 0; ((tail < frames) || (head < tail)) && !failed; ) {
+		// Send the next frame when there is room for it, a frame that did not fit is sent again.
+		if ((tail < frames) && (tail - head < TEST_QUEUE_LENGTH)) {
+			uint8_t * const payload = sent[tail % TEST_QUEUE_LENGTH];
+			if (!pending) {
+				sentLen[tail % TEST_QUEUE_LENGTH] = Test_payload(payload, codec == CircularFrame_SLIP, TEST_UART_PAYLOAD);
+				pending = true;
+			}
+			if (CircularUART_SendFrame(&uart, codec, payload, sentLen[tail % TEST_QUEUE_LENGTH])) {
+				tail++;
+				pending = false;
+			}
+		}
+
+		// Move a random step and decode what arrived.
+		Test_runDma((uint32_t)(1 + rand() % 64));
+		uint16_t len = 0;
+		bool decoded = false;
+		while (CircularFrame_decode(&decoder, data, sizeof(data), &len)) {
+			if ((head == tail) || (len != sentLen[head % TEST_QUEUE_LENGTH]) || memcmp(data, sent[head % TEST_QUEUE_LENGTH], len)) {
+				Test_fail("frame lost or corrupted on the line", codec);
+				return;
+			}
+			head++;
+			frameCount++;
+			decoded = true;
+		}
+		stalls = decoded ? 0 : stalls + 1;
+		if (stalls > 1000) {
+			Test_fail("line stalled", codec);
+		}
+	}
+	if (decoder.discardedFrames || CircularBuffer_getUnreadSize(&uart.rxBufferObject)) {
+		Test_fail("frame discarded or left on the line", codec);
+	}
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	const uint32_t frames = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000UL;
+
+	// Rings that are not a power of 2.
+	srand(1);
+	CircularBuffer_initWithLength(&ring, ringMemory, sizeof(ringMemory));
+	CircularBuffer_initWithLength(&scratch, scratchMemory, sizeof(scratchMemory));
+	Test_vectors();
+	for (CircularFrameCodec_t codec = CircularFrame_COBS; codec <= CircularFrame_HDLC; codec++) {
+		Test_fit(codec);
+		Test_roundTrip(codec, frames);
+		Test_damaged(codec);
+	}
+	if (!wrapCount) {
+		Test_fail("no frame wrapped the ring end", CircularFrame_COBS);
+	}
+
+	// Through the tx DMA of USART2, DMA1 channel 7, looped back into the rx buffer.
+	CircularUART_Init(&uart, &CircularUART_USART2, 115200, 0);
+	CircularUART_StartTx(&uart, txMemory, TEST_TX_LENGTH_2N);
+	CircularUART_StartRx(&uart, rxMemory, TEST_RX_LENGTH_2N);
+	for (CircularFrameCodec_t codec = CircularFrame_COBS; codec <= CircularFrame_HDLC; codec++) {
+		Test_uart(codec, frames / 4);
+	}
+
+	// Result.
+	if (!failed) {
+		printf("PASS: %u frames, %u wrapped the ring end, %u damaged frames discarded\n", frameCount, wrapCount, discardCount);
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * @brief Enables or disables a channel. On enable checks the transfer against the buffer memory.
+ */
+void DMA_Cmd(DMA_Channel_TypeDef * DMAy_Channelx, FunctionalState NewState) {
+	if (NewState == DISABLE) {
+		DMAy_Channelx->CCR &= ~DMA_CCR1_EN;
+		return;
+	}
+	DMAy_Channelx->CCR |= DMA_CCR1_EN;
+	dmaDone = 0;
+
+	// A transfer is a span within the memory.
+	const uint8_t * const start = (const uint8_t *)(((uintptr_t)txMemory & ~(uintptr_t)0xFFFFFFFFUL) | DMAy_Channelx->CMAR);
+	if (!DMAy_Channelx->CNDTR || (start < txMemory) || (start + DMAy_Channelx->CNDTR > txMemory + sizeof(txMemory))) {
+		Test_fail("transfer outside of the buffer memory", CircularFrame_COBS);
+	}
+}
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT) {
+	return (pendingComplete & DMAy_IT) ? SET : RESET;
+}
+void DMA_ClearITPendingBit(uint32_t DMAy_IT) {
+	pendingComplete &= ~DMAy_IT;
+}
+
+// Peripherals without behavior in this test.
+void NVIC_DisableIRQ(IRQn_Type IRQn) { (void)IRQn; }
+void NVIC_EnableIRQ(IRQn_Type IRQn) { (void)IRQn; }
+void GPIO_Init(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_InitStruct) { (void)GPIOx; (void)GPIO_InitStruct; }
+void GPIO_SetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void GPIO_ResetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) { (void)RCC_APB1Periph; (void)NewState; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void)RCC_APB2Periph; (void)NewState; }
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState) { (void)RCC_AHBPeriph; (void)NewState; }
+void NVIC_Init(NVIC_InitTypeDef * NVIC_InitStruct) { (void)NVIC_InitStruct; }
+void USART_Init(USART_TypeDef * USARTx, USART_InitTypeDef * USART_InitStruct) { (void)USARTx; (void)USART_InitStruct; }
+void USART_Cmd(USART_TypeDef * USARTx, FunctionalState NewState) { (void)USARTx; (void)NewState; }
+void USART_ITConfig(USART_TypeDef * USARTx, uint16_t USART_IT, FunctionalState NewState) { (void)USARTx; (void)USART_IT; (void)NewState; }
+void USART_DMACmd(USART_TypeDef * USARTx, uint16_t USART_DMAReq, FunctionalState NewState) { (void)USARTx; (void)USART_DMAReq; (void)NewState; }
+void USART_SendData(USART_TypeDef * USARTx, uint16_t Data) { (void)USARTx; (void)Data; }
+uint16_t USART_ReceiveData(USART_TypeDef * USARTx) { (void)USARTx; return 0; }
+FlagStatus USART_GetFlagStatus(USART_TypeDef * USARTx, uint16_t USART_FLAG) { (void)USARTx; (void)USART_FLAG; return RESET; }
+void USART_ClearFlag(USART_TypeDef * USARTx, uint16_t USART_FLAG) { (void)USARTx; (void)USART_FLAG; }
+ITStatus USART_GetITStatus(USART_TypeDef * USARTx, uint16_t USART_IT) { (void)USARTx; (void)USART_IT; return RESET; }
+void DMA_DeInit(DMA_Channel_TypeDef * DMAy_Channelx) { memset((void *)DMAy_Channelx, 0, sizeof(*DMAy_Channelx)); }
+void DMA_Init(DMA_Channel_TypeDef * DMAy_Channelx, DMA_InitTypeDef * DMA_InitStruct) { (void)DMAy_Channelx; (void)DMA_InitStruct; }
+void DMA_ITConfig(DMA_Channel_TypeDef * DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState) { (void)DMAy_Channelx; (void)DMA_IT; (void)NewState; }
+uint32_t CircularUART_GetTick(void) { return 0; }
@@ -0,0 +1,204 @@
+/**
+ * @file      circularmemory.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Huge-page and NUMA-aware arena for circular buffer memory on Linux.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#define _GNU_SOURCE
+#include "circularmemory.h"
+#include <assert.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Memory policy of the mbind and get_mempolicy system calls, without depending on libnuma.
+#define CIRCULARMEMORY_MPOL_BIND 2
+#define CIRCULARMEMORY_MPOL_MF_STRICT (1 << 0)
+#define CIRCULARMEMORY_MPOL_MF_MOVE (1 << 1)
+#define CIRCULARMEMORY_MPOL_F_NODE (1 << 0)
+#define CIRCULARMEMORY_MPOL_F_ADDR (1 << 1)
+#define CIRCULARMEMORY_NODES_MAX 1024
+
+/*
+ * @brief Reads how much of a mapping is backed by transparent huge pages.
+ * @param memory Start of the mapping.
+ * @return Bytes backed by transparent huge pages.
+ */
+static size_t CircularMemory_transparentHugeBytes(const uint8_t * const memory) {
+	char line[256];
+	size_t result = 0;
+	bool inMapping = false;
+	FILE * const smaps = fopen("/proc/self/smaps", "r");
+	if (!smaps) {
+		return 0;
+	}
+
+	// Find the mapping by its start address, then its AnonHugePages line.
+	while (fgets(line, sizeof(line), smaps)) {
+		unsigned long start, end, kilobytes;
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+			inMapping = ((uintptr_t)memory >= start) && ((uintptr_t)memory < end);
+		} else if (inMapping && (sscanf(line, "AnonHugePages: %lu kB", &kilobytes) == 1)) {
+			result = (size_t)kilobytes << 10;
+			break;
+		}
+	}
+	fclose(smaps);
+	return result;
+}
+
+/*
+ * @brief Maps an arena for many circular buffers, i.e. many 64 KiB rings in one 2 MiB huge page. Tries explicit
+ *        huge pages first, then transparent huge pages, binds it to a NUMA node and prefaults it. Every step is
+ *        best effort, the arena works with plain pages on any node, the fields tell what was obtained.
+ * @param arena The arena.
+ * @param size Size in bytes, rounded up to the huge page size.
+ * @param node NUMA node to bind to, i.e. the node of the consumer, -1 for the default policy.
+ * @return Returns true on success, false if no memory could be mapped.
+ */
+bool CircularMemory_init(CircularMemory_t * const arena, const size_t size, const int node) {
+	// Arena check.
+	assert(arena && size && (node < CIRCULARMEMORY_NODES_MAX));
+	memset(arena, 0, sizeof(*arena));
+	arena->requestedNode = node;
+	arena->node = -1;
+	arena->size = (size + CIRCULARMEMORY_HUGEPAGE_SIZE - 1) & ~(CIRCULARMEMORY_HUGEPAGE_SIZE - 1);
+
+	// Explicit huge pages, only if the administrator reserved them.
+	void * memory = mmap(NULL, arena->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (memory != MAP_FAILED) {
+		arena->hugeTlb = true;
+	} else {
+		// Map one huge page more to align the start, so the kernel can use huge pages from the first byte.
+		uint8_t * const raw = mmap(NULL, arena->size + CIRCULARMEMORY_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == MAP_FAILED) {
+			return false;
+		}
+		uint8_t * const aligned = (uint8_t *)(((uintptr_t)raw + CIRCULARMEMORY_HUGEPAGE_SIZE - 1) & ~(uintptr_t)(CIRCULARMEMORY_HUGEPAGE_SIZE - 1));
+		if (aligned > raw) {
+			munmap(raw, aligned - raw);
+		}
+		munmap(aligned + arena->size, (raw + CIRCULARMEMORY_HUGEPAGE_SIZE) - aligned);
+		memory = aligned;
+#ifdef MADV_HUGEPAGE
+		madvise(memory, arena->size, MADV_HUGEPAGE);
+#endif
+	}
+	arena->memory = memory;
+
+	// Bind before the first touch, so the pages are allocated on the node.
+	if (node >= 0) {
+		unsigned long nodemask[CIRCULARMEMORY_NODES_MAX / (8 * sizeof(unsigned long))] = {0};
+		nodemask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+		arena->bound = !syscall(SYS_mbind, memory, arena->size, CIRCULARMEMORY_MPOL_BIND, nodemask,
+			(unsigned long)CIRCULARMEMORY_NODES_MAX, CIRCULARMEMORY_MPOL_MF_STRICT | CIRCULARMEMORY_MPOL_MF_MOVE);
+	}
+
+	// Prefault every page, so the producer does not take page faults on the first lap.
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	for (size_t offset = 0; offset < arena->size; offset += (size_t)pageSize) {
+		((volatile uint8_t *)memory)[offset] = 0;
+	}
+	arena->prefaulted = true;
+
+	// Report what was obtained.
+	int actualNode = -1;
+	if (!syscall(SYS_get_mempolicy, &actualNode, NULL, 0UL, memory, CIRCULARMEMORY_MPOL_F_NODE | CIRCULARMEMORY_MPOL_F_ADDR)) {
+		arena->node = actualNode;
+	}
+	arena->hugeBytes = arena->hugeTlb ? arena->size : CircularMemory_transparentHugeBytes(memory);
+	arena->transparentHugePages = !arena->hugeTlb && arena->hugeBytes;
+	return true;
+}
+
+/*
+ * @brief Unmaps the arena, the buffers carved from it must not be used any more.
+ * @param arena The arena.
+ */
+void CircularMemory_release(CircularMemory_t * const arena) {
+	// Arena check.
+	assert(arena);
+
+	if (arena->memory) {
+		munmap(arena->memory, arena->size);
+		arena->memory = NULL;
+	}
+}
+
+/*
+ * @brief Carves the memory of one buffer from the arena, aligned to a cache line so buffers do not share lines.
+ * @param arena The arena.
+ * @param length Size of the buffer memory in bytes, up to 65536.
+ * @return Pointer to the buffer memory, NULL if the arena is exhausted.
+ */
+uint8_t * CircularMemory_carve(CircularMemory_t * const arena, const uint32_t length) {
+	// Arena check.
+	assert(arena && arena->memory);
+
+	const size_t aligned = (length + CIRCULARMEMORY_ALIGNMENT - 1) & ~(size_t)(CIRCULARMEMORY_ALIGNMENT - 1);
+	if (aligned > arena->size - arena->used) {
+		return NULL;
+	}
+	uint8_t * const memory = arena->memory + arena->used;
+	arena->used += aligned;
+	return memory;
+}
+
+/*
+ * @brief Initializes a buffer on memory carved from the arena.
+ * @param arena The arena.
+ * @param bufferObject The buffer object handler.
+ * @param length Size of the buffer memory in bytes, up to 65536.
+ * @return Returns true on success, false if the arena is exhausted.
+ */
+bool CircularMemory_initBuffer(CircularMemory_t * const arena, CircularBufferObject_t * const bufferObject, const uint32_t length) {
+	uint8_t * const memory = CircularMemory_carve(arena, length);
+	if (!memory) {
+		return false;
+	}
+	CircularBuffer_initWithLength(bufferObject, memory, length);
+	return true;
+}
+
+/*
+ * @brief Prints what the arena obtained.
+ * @param arena The arena.
+ * @param stream The output stream.
+ */
+void CircularMemory_report(CircularMemory_t * const arena, FILE * const stream) {
+	// Arena check.
+	assert(arena && stream);
+
+	fprintf(stream, "arena %zu KiB at %p, %zu KiB used\n", arena->size >> 10, (void *)arena->memory, arena->used >> 10);
+	fprintf(stream, "pages: %s, %zu KiB huge\n", arena->hugeTlb ? "hugetlb" : (arena->transparentHugePages ? "transparent huge" : "base"), arena->hugeBytes >> 10);
+	if (arena->requestedNode >= 0) {
+		fprintf(stream, "numa: node %d requested, %s, on node %d\n", arena->requestedNode, arena->bound ? "bound" : "not bound", arena->node);
+	} else {
+		fprintf(stream, "numa: default policy, on node %d\n", arena->node);
+	}
+	fprintf(stream, "prefaulted: %s\n", arena->prefaulted ? "yes" : "no");
+}
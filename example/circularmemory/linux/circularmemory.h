@@ -0,0 +1,66 @@
+/**
+ * @file      circularmemory.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Huge-page and NUMA-aware arena for circular buffer memory on Linux.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Protection.
+#ifndef _H_CIRCULARMEMORY
+#define _H_CIRCULARMEMORY
+
+// Includes.
+#include <stddef.h>
+#include "circularbuffer.h"
+
+// Settings.
+#ifndef CIRCULARMEMORY_HUGEPAGE_SIZE
+#define CIRCULARMEMORY_HUGEPAGE_SIZE (2UL << 20)
+#endif
+#ifndef CIRCULARMEMORY_ALIGNMENT
+#define CIRCULARMEMORY_ALIGNMENT 64
+#endif
+
+// Type definitions.
+typedef struct{
+	uint8_t * memory;
+	size_t size;
+	size_t used;
+	int requestedNode;
+	int node;
+	bool hugeTlb;
+	bool transparentHugePages;
+	size_t hugeBytes;
+	bool bound;
+	bool prefaulted;
+}CircularMemory_t;
+
+// Prototypes.
+bool CircularMemory_init(CircularMemory_t * const arena, const size_t size, const int node);
+void CircularMemory_release(CircularMemory_t * const arena);
+uint8_t * CircularMemory_carve(CircularMemory_t * const arena, const uint32_t length);
+bool CircularMemory_initBuffer(CircularMemory_t * const arena, CircularBufferObject_t * const bufferObject, const uint32_t length);
+void CircularMemory_report(CircularMemory_t * const arena, FILE * const stream);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file      circularmemorydemo.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Maps an arena, carves buffers from it and reports the pages and the NUMA node obtained.
+ * @usage     gcc -O2 -I../../.. circularmemorydemo.c circularmemory.c ../../../circularbuffer.c -o circularmemorydemo
+ *            ./circularmemorydemo [node] [buffers]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularmemory.h"
+#include <stdlib.h>
+
+// Settings.
+#define DEMO_BUFFER_LENGTH 65536UL
+
+int main(int argc, char ** argv) {
+	const int node = (argc > 1) ? atoi(argv[1]) : -1;
+	const uint32_t count = (argc > 2) ? (uint32_t)atoi(argv[2]) : 32;
+	CircularBufferObject_t * const bufferObjects = calloc(count, sizeof(CircularBufferObject_t));
+	CircularMemory_t arena;
+	if (!bufferObjects || !CircularMemory_init(&arena, count * DEMO_BUFFER_LENGTH, node)) {
+		fprintf(stderr, "cannot map the arena\n");
+		return 1;
+	}
+
+	// Many buffers of the maximum length in one arena.
+	for (uint32_t i = 0; i < count; i++) {
+		if (!CircularMemory_initBuffer(&arena, &bufferObjects[i], DEMO_BUFFER_LENGTH)) {
+			fprintf(stderr, "arena exhausted at buffer %u\n", i);
+			return 1;
+		}
+	}
+	CircularMemory_report(&arena, stdout);
+	CircularMemory_release(&arena);
+	free(bufferObjects);
+	return 0;
+}
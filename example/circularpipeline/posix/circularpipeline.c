@@ -0,0 +1,377 @@
+/**
+ * @file      circularpipeline.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Pipeline of stages between circular buffers, run by a pool of POSIX threads.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularpipeline.h"
+#include <assert.h>
+#include <time.h>
+
+// Stages of one buffer run on different threads over time.
+#if !CIRCULARBUFFER_SMP
+#error "CircularPipeline needs the library built with CIRCULARBUFFER_SMP=1"
+#endif
+
+// Settings.
+#ifndef CIRCULARPIPELINE_IDLE_NS
+#define CIRCULARPIPELINE_IDLE_NS 1000000L
+#endif
+#ifndef CIRCULARPIPELINE_RUN_SPANS
+#define CIRCULARPIPELINE_RUN_SPANS 4
+#endif
+
+// Metrics are written by the thread running the stage and read by any thread.
+#define CircularPipeline_count(stage, counter, value) __atomic_fetch_add(&(stage)->metrics.counter, (value), __ATOMIC_RELAXED)
+
+/*
+ * @brief Reads the monotonic clock.
+ * @return Time in nanoseconds.
+ */
+static uint64_t CircularPipeline_nanoseconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * @brief Initializes an empty pipeline.
+ * @param pipeline The pipeline.
+ */
+void CircularPipeline_init(CircularPipeline_t * const pipeline) {
+	// Pipeline check.
+	assert(pipeline);
+
+	memset(pipeline, 0, sizeof(*pipeline));
+	pthread_mutex_init(&pipeline->mutex, NULL);
+	pthread_cond_init(&pipeline->wakeup, NULL);
+}
+
+/*
+ * @brief Adds a stage before the pipeline is started. Each buffer must be the input of at most one stage and the
+ *        output of at most one stage, the other ends belong to the application.
+ * @param pipeline The pipeline.
+ * @param input The input buffer, NULL for a source stage.
+ * @param output The output buffer, NULL for a sink stage.
+ * @param function The stage function.
+ * @param context Context passed to the function.
+ * @return Index of the stage, -1 if there is no room.
+ */
+int CircularPipeline_addStage(CircularPipeline_t * const pipeline, CircularBufferObject_t * const input, CircularBufferObject_t * const output, const CircularPipelineFunction_t function, void * const context) {
+	// Pipeline check.
+	assert(pipeline && function && (input || output) && !pipeline->threadCount);
+
+	if (pipeline->stageCount == CIRCULARPIPELINE_STAGES_MAX) {
+		return -1;
+	}
+	CircularPipelineStage_t * const stage = &pipeline->stages[pipeline->stageCount];
+	stage->input = input;
+	stage->output = output;
+	stage->function = function;
+	stage->context = context;
+	return pipeline->stageCount++;
+}
+
+/*
+ * @brief Runs a stage on linear copies of the head of its input and of the free space of its output, for a unit that
+ *        straddles the wrap of either buffer.
+ * @param stage The stage.
+ * @param inputLen Size of the input span the stage moved nothing from.
+ * @param outputLen Size of the output span.
+ * @param produced Pointer to write the number of bytes produced.
+ * @return Number of bytes consumed.
+ */
+static uint16_t CircularPipeline_runLinear(CircularPipelineStage_t * const stage, const uint16_t inputLen, const uint16_t outputLen, uint16_t * const produced) {
+	const uint8_t * input = NULL;
+	uint8_t * output = NULL;
+	uint16_t linearInputLen = 0, linearOutputLen = 0;
+
+	// Sizes across the wrap, limited by the scratch.
+	*produced = 0;
+	if (stage->input) {
+		linearInputLen = CircularBuffer_getUnreadSize(stage->input);
+		if (linearInputLen > CIRCULARPIPELINE_SCRATCH_LENGTH) {
+			linearInputLen = CIRCULARPIPELINE_SCRATCH_LENGTH;
+		}
+	}
+	if (stage->output) {
+		linearOutputLen = stage->output->capacity - CircularBuffer_getUnreadSize(stage->output);
+		if (linearOutputLen > CIRCULARPIPELINE_SCRATCH_LENGTH) {
+			linearOutputLen = CIRCULARPIPELINE_SCRATCH_LENGTH;
+		}
+	}
+
+	// Nothing more to show than the spans did.
+	if ((linearInputLen <= inputLen) && (linearOutputLen <= outputLen)) {
+		return 0;
+	}
+
+	// Run on the copies, then consume and publish.
+	if (stage->input) {
+		input = stage->inputScratch;
+		linearInputLen = CircularBuffer_peek(stage->input, 0, stage->inputScratch, linearInputLen);
+	}
+	if (stage->output) {
+		output = stage->outputScratch;
+	}
+	const uint16_t consumed = stage->function(input, linearInputLen, output, linearOutputLen, produced, stage->context);
+	assert((consumed <= linearInputLen) && (*produced <= linearOutputLen));
+	if (consumed) {
+		CircularBuffer_advanceFront(stage->input, consumed);
+	}
+	if (*produced) {
+		CircularBuffer_pushBack(stage->output, stage->outputScratch, *produced);
+	}
+	return consumed;
+}
+
+/*
+ * @brief Runs a claimed stage while its input has data and its output has space.
+ * @param stage The stage.
+ * @return Returns true if the stage moved any data.
+ */
+static bool CircularPipeline_runStage(CircularPipelineStage_t * const stage) {
+	const uint64_t start = CircularPipeline_nanoseconds();
+	uint64_t consumedTotal = 0, producedTotal = 0;
+
+	// A span ends at the end of the buffer memory, the rest is run as the next span.
+	for (uint16_t span = 0; span < CIRCULARPIPELINE_RUN_SPANS; span++) {
+		const uint8_t * input = NULL;
+		uint8_t * output = NULL;
+		uint16_t inputLen = 0, outputLen = 0, produced = 0;
+		if (stage->input && !(inputLen = CircularBuffer_getFrontSpan(stage->input, &input))) {
+			break;
+		}
+		if (stage->output && !(outputLen = CircularBuffer_getBackSpan(stage->output, &output))) {
+			break;
+		}
+
+		// Run and publish, or run again across the wrap if a span was too short for the stage.
+		uint16_t consumed = stage->function(input, inputLen, output, outputLen, &produced, stage->context);
+		assert((consumed <= inputLen) && (produced <= outputLen));
+		if (consumed) {
+			CircularBuffer_advanceFront(stage->input, consumed);
+		}
+		if (produced) {
+			CircularBuffer_advanceBack(stage->output, produced);
+		}
+		if (!consumed && !produced) {
+			consumed = CircularPipeline_runLinear(stage, inputLen, outputLen, &produced);
+		}
+		consumedTotal += consumed;
+		producedTotal += produced;
+		if (!consumed && !produced) {
+			break;
+		}
+	}
+
+	// Metrics.
+	CircularPipeline_count(stage, runs, 1);
+	CircularPipeline_count(stage, consumedBytes, consumedTotal);
+	CircularPipeline_count(stage, producedBytes, producedTotal);
+	CircularPipeline_count(stage, busyNanoseconds, CircularPipeline_nanoseconds() - start);
+	return consumedTotal || producedTotal;
+}
+
+/*
+ * @brief Records the stall state of a stage, counting only the entries into a stall so that repeated scans and idle
+ *        polls of a waiting stage count once.
+ * @param stage The stage.
+ * @param stall The new state.
+ */
+static void CircularPipeline_setStall(CircularPipelineStage_t * const stage, const CircularPipelineStall_t stall) {
+	if (stall != stage->stall) {
+		if (stall == CircularPipeline_INPUT_STALLED) {
+			CircularPipeline_count(stage, inputStalls, 1);
+		} else if (stall == CircularPipeline_OUTPUT_STALLED) {
+			CircularPipeline_count(stage, outputStalls, 1);
+		}
+		stage->stall = stall;
+	}
+}
+
+/*
+ * @brief Checks if a stage can run, and records why not.
+ * @param stage The stage.
+ * @return Returns true if the input has data and the output has space.
+ */
+static bool CircularPipeline_isReady(CircularPipelineStage_t * const stage) {
+	const bool hasInput = !stage->input || CircularBuffer_getUnreadSize(stage->input);
+	const bool hasSpace = !stage->output || (CircularBuffer_getUnreadSize(stage->output) < stage->output->capacity);
+	if (!hasInput) {
+		CircularPipeline_setStall(stage, CircularPipeline_INPUT_STALLED);
+	} else if (!hasSpace) {
+		CircularPipeline_setStall(stage, CircularPipeline_OUTPUT_STALLED);
+	}
+	return hasInput && hasSpace;
+}
+
+/*
+ * @brief Wakes the idle workers after data was moved.
+ * @param pipeline The pipeline.
+ */
+static void CircularPipeline_wake(CircularPipeline_t * const pipeline) {
+	__atomic_fetch_add(&pipeline->generation, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&pipeline->sleepers, __ATOMIC_SEQ_CST)) {
+		pthread_mutex_lock(&pipeline->mutex);
+		pthread_cond_broadcast(&pipeline->wakeup);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+}
+
+/*
+ * @brief Worker thread. Scans the stages starting at its own, so workers spread over the stages, and takes any
+ *        ready stage that is not running on another worker. A stage runs on one worker at a time, so each buffer
+ *        keeps a single producer and a single consumer.
+ * @param argument The worker.
+ */
+static void * CircularPipeline_worker(void * const argument) {
+	CircularPipelineWorker_t * const worker = argument;
+	CircularPipeline_t * const pipeline = worker->pipeline;
+	uint16_t next = worker->index % pipeline->stageCount;
+
+	while (!__atomic_load_n(&pipeline->stop, __ATOMIC_ACQUIRE)) {
+		const uint32_t generation = __atomic_load_n(&pipeline->generation, __ATOMIC_SEQ_CST);
+		bool progress = false;
+
+		// One round over the stages.
+		for (uint16_t visited = 0; visited < pipeline->stageCount; visited++) {
+			CircularPipelineStage_t * const stage = &pipeline->stages[next];
+			next = (next + 1 == pipeline->stageCount) ? 0 : next + 1;
+
+			// Claim, the acquire pairs with the release of the previous worker of this stage.
+			int expected = 0;
+			if (__atomic_load_n(&stage->claimed, __ATOMIC_RELAXED)
+				|| !__atomic_compare_exchange_n(&stage->claimed, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+				continue;
+			}
+			// The stall state belongs to the claiming worker. A ready stage that moves nothing waits for more input,
+			// i.e. the rest of a unit.
+			if (CircularPipeline_isReady(stage)) {
+				if (CircularPipeline_runStage(stage)) {
+					CircularPipeline_setStall(stage, CircularPipeline_RUNNING);
+					progress = true;
+				} else {
+					CircularPipeline_setStall(stage, stage->input ? CircularPipeline_INPUT_STALLED : CircularPipeline_OUTPUT_STALLED);
+				}
+			}
+			__atomic_store_n(&stage->claimed, 0, __ATOMIC_RELEASE);
+		}
+
+		// Wake the others, or sleep until data moves, polling the application ends of the buffers meanwhile.
+		if (progress) {
+			CircularPipeline_wake(pipeline);
+		} else {
+			pthread_mutex_lock(&pipeline->mutex);
+			__atomic_fetch_add(&pipeline->sleepers, 1, __ATOMIC_SEQ_CST);
+			if ((__atomic_load_n(&pipeline->generation, __ATOMIC_SEQ_CST) == generation) && !pipeline->stop) {
+				struct timespec deadline;
+				clock_gettime(CLOCK_REALTIME, &deadline);
+				deadline.tv_nsec += CIRCULARPIPELINE_IDLE_NS;
+				if (deadline.tv_nsec >= 1000000000L) {
+					deadline.tv_sec++;
+					deadline.tv_nsec -= 1000000000L;
+				}
+				pthread_cond_timedwait(&pipeline->wakeup, &pipeline->mutex, &deadline);
+			}
+			__atomic_fetch_sub(&pipeline->sleepers, 1, __ATOMIC_SEQ_CST);
+			pthread_mutex_unlock(&pipeline->mutex);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * @brief Starts the worker threads.
+ * @param pipeline The pipeline.
+ * @param threads Number of worker threads.
+ * @return Returns true on success.
+ */
+bool CircularPipeline_start(CircularPipeline_t * const pipeline, const uint16_t threads) {
+	// Pipeline check.
+	assert(pipeline && pipeline->stageCount && threads && (threads <= CIRCULARPIPELINE_THREADS_MAX));
+
+	pipeline->stop = false;
+	for (uint16_t i = 0; i < threads; i++) {
+		pipeline->workers[i].pipeline = pipeline;
+		pipeline->workers[i].index = i;
+		if (pthread_create(&pipeline->threads[i], NULL, CircularPipeline_worker, &pipeline->workers[i])) {
+			CircularPipeline_stop(pipeline);
+			return false;
+		}
+		pipeline->threadCount++;
+	}
+	return true;
+}
+
+/*
+ * @brief Stops and joins the worker threads, stages are not interrupted while running.
+ * @param pipeline The pipeline.
+ */
+void CircularPipeline_stop(CircularPipeline_t * const pipeline) {
+	// Pipeline check.
+	assert(pipeline);
+
+	pthread_mutex_lock(&pipeline->mutex);
+	__atomic_store_n(&pipeline->stop, true, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&pipeline->wakeup);
+	pthread_mutex_unlock(&pipeline->mutex);
+	for (uint16_t i = 0; i < pipeline->threadCount; i++) {
+		pthread_join(pipeline->threads[i], NULL);
+	}
+	pipeline->threadCount = 0;
+}
+
+/*
+ * @brief Wakes the workers after the application pushed into an input or popped from an output of the pipeline.
+ *        Without it the workers still notice within CIRCULARPIPELINE_IDLE_NS.
+ * @param pipeline The pipeline.
+ */
+void CircularPipeline_notify(CircularPipeline_t * const pipeline) {
+	// Pipeline check.
+	assert(pipeline);
+
+	CircularPipeline_wake(pipeline);
+}
+
+/*
+ * @brief Reads the metrics of a stage.
+ * @param pipeline The pipeline.
+ * @param index Index of the stage.
+ * @param metrics Pointer to write the metrics.
+ */
+void CircularPipeline_getMetrics(CircularPipeline_t * const pipeline, const uint16_t index, CircularPipelineMetrics_t * const metrics) {
+	// Pipeline check.
+	assert(pipeline && (index < pipeline->stageCount) && metrics);
+
+	const CircularPipelineMetrics_t * const source = &pipeline->stages[index].metrics;
+	metrics->runs = __atomic_load_n(&source->runs, __ATOMIC_RELAXED);
+	metrics->consumedBytes = __atomic_load_n(&source->consumedBytes, __ATOMIC_RELAXED);
+	metrics->producedBytes = __atomic_load_n(&source->producedBytes, __ATOMIC_RELAXED);
+	metrics->inputStalls = __atomic_load_n(&source->inputStalls, __ATOMIC_RELAXED);
+	metrics->outputStalls = __atomic_load_n(&source->outputStalls, __ATOMIC_RELAXED);
+	metrics->busyNanoseconds = __atomic_load_n(&source->busyNanoseconds, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file      circularpipeline.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Pipeline of stages between circular buffers, run by a pool of POSIX threads.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Protection.
+#ifndef _H_CIRCULARPIPELINE
+#define _H_CIRCULARPIPELINE
+
+// Includes.
+#include <pthread.h>
+#include "circularbuffer.h"
+
+// Settings.
+#ifndef CIRCULARPIPELINE_STAGES_MAX
+#define CIRCULARPIPELINE_STAGES_MAX 16
+#endif
+#ifndef CIRCULARPIPELINE_THREADS_MAX
+#define CIRCULARPIPELINE_THREADS_MAX 16
+#endif
+#ifndef CIRCULARPIPELINE_SCRATCH_LENGTH
+#define CIRCULARPIPELINE_SCRATCH_LENGTH 256
+#endif
+
+/*
+ * @brief Stage function. Consumes from the contiguous unread span of the input buffer and produces into the
+ *        contiguous free span of the output buffer. Called again for the rest after a wrap. A stage that moves
+ *        nothing while a span is cut short by the wrap is called once more on linear copies of up to
+ *        CIRCULARPIPELINE_SCRATCH_LENGTH bytes of each side, so a unit that straddles the wrap is seen whole. A stage
+ *        that needs more than that, i.e. a whole message, consumes what it can into its own context and returns that.
+ * @param input Unread span of the input buffer, NULL for a source stage.
+ * @param inputLen Size of the input span.
+ * @param output Free span of the output buffer, NULL for a sink stage.
+ * @param outputLen Size of the output span.
+ * @param produced Pointer to write the number of bytes produced into the output span.
+ * @param context Context given when the stage was added.
+ * @return Number of bytes consumed from the input span.
+ */
+typedef uint16_t (*CircularPipelineFunction_t)(const uint8_t * const input, const uint16_t inputLen, uint8_t * const output, const uint16_t outputLen, uint16_t * const produced, void * const context);
+
+// Type definitions.
+typedef struct{
+	uint64_t runs;
+	uint64_t consumedBytes;
+	uint64_t producedBytes;
+	uint64_t inputStalls;
+	uint64_t outputStalls;
+	uint64_t busyNanoseconds;
+}CircularPipelineMetrics_t;
+typedef enum{
+	CircularPipeline_RUNNING = 0,
+	CircularPipeline_INPUT_STALLED,
+	CircularPipeline_OUTPUT_STALLED
+}CircularPipelineStall_t;
+typedef struct{
+	CircularBufferObject_t * input;
+	CircularBufferObject_t * output;
+	CircularPipelineFunction_t function;
+	void * context;
+	int claimed;
+	CircularPipelineStall_t stall;
+	uint8_t inputScratch[CIRCULARPIPELINE_SCRATCH_LENGTH];
+	uint8_t outputScratch[CIRCULARPIPELINE_SCRATCH_LENGTH];
+	CircularPipelineMetrics_t metrics;
+}CircularPipelineStage_t;
+typedef struct CircularPipeline_s CircularPipeline_t;
+typedef struct{
+	CircularPipeline_t * pipeline;
+	uint16_t index;
+}CircularPipelineWorker_t;
+struct CircularPipeline_s{
+	CircularPipelineStage_t stages[CIRCULARPIPELINE_STAGES_MAX];
+	uint16_t stageCount;
+	pthread_t threads[CIRCULARPIPELINE_THREADS_MAX];
+	CircularPipelineWorker_t workers[CIRCULARPIPELINE_THREADS_MAX];
+	uint16_t threadCount;
+	pthread_mutex_t mutex;
+	pthread_cond_t wakeup;
+	uint32_t generation;
+	uint16_t sleepers;
+	bool stop;
+};
+
+// Prototypes.
+void CircularPipeline_init(CircularPipeline_t * const pipeline);
+int CircularPipeline_addStage(CircularPipeline_t * const pipeline, CircularBufferObject_t * const input, CircularBufferObject_t * const output, const CircularPipelineFunction_t function, void * const context);
+bool CircularPipeline_start(CircularPipeline_t * const pipeline, const uint16_t threads);
+void CircularPipeline_stop(CircularPipeline_t * const pipeline);
+void CircularPipeline_notify(CircularPipeline_t * const pipeline);
+void CircularPipeline_getMetrics(CircularPipeline_t * const pipeline, const uint16_t index, CircularPipelineMetrics_t * const metrics);
+
+#endif
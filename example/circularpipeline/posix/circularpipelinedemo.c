@@ -0,0 +1,140 @@
+/**
+ * @file      circularpipelinedemo.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Demo of a three-stage pipeline between four buffers with per-stage metrics.
+ * @usage     gcc -O2 -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularpipelinedemo.c circularpipeline.c ../../../circularbuffer.c -o circularpipelinedemo
+ *            ./circularpipelinedemo [threads] [seconds]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularpipeline.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Settings.
+#define DEMO_RING_LENGTH 4000
+
+// Variables.
+static uint8_t memory[4][DEMO_RING_LENGTH];
+static CircularBufferObject_t rings[4];
+
+/*
+ * @brief Adds one to every byte.
+ */
+static uint16_t Demo_increment(const uint8_t * const input, const uint16_t inputLen, uint8_t * const output, const uint16_t outputLen, uint16_t * const produced, void * const context) {
+	const uint16_t len = (inputLen < outputLen) ? inputLen : outputLen;
+	(void)context;
+	for (uint16_t i = 0; i < len; i++) {
+		output[i] = input[i] + 1;
+	}
+	*produced = len;
+	return len;
+}
+
+/*
+ * @brief Inverts every byte.
+ */
+static uint16_t Demo_invert(const uint8_t * const input, const uint16_t inputLen, uint8_t * const output, const uint16_t outputLen, uint16_t * const produced, void * const context) {
+	const uint16_t len = (inputLen < outputLen) ? inputLen : outputLen;
+	(void)context;
+	for (uint16_t i = 0; i < len; i++) {
+		output[i] = ~input[i];
+	}
+	*produced = len;
+	return len;
+}
+
+/*
+ * @brief Copies in whole 16-byte blocks only, leaving partial blocks for the next run.
+ */
+static uint16_t Demo_block(const uint8_t * const input, const uint16_t inputLen, uint8_t * const output, const uint16_t outputLen, uint16_t * const produced, void * const context) {
+	uint16_t len = (inputLen < outputLen) ? inputLen : outputLen;
+	(void)context;
+	len &= ~(uint16_t)15;
+	memcpy(output, input, len);
+	*produced = len;
+	return len;
+}
+
+int main(int argc, char ** argv) {
+	const uint16_t threads = (argc > 1) ? (uint16_t)atoi(argv[1]) : 2;
+	const double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+	static const char * const names[] = {"increment", "invert", "block"};
+	CircularPipeline_t pipeline;
+	uint8_t data[1024];
+	uint64_t sent = 0, received = 0;
+	bool failed = false;
+
+	// Application -> increment -> invert -> block -> application.
+	for (uint16_t i = 0; i < 4; i++) {
+		CircularBuffer_initWithLength(&rings[i], memory[i], DEMO_RING_LENGTH);
+	}
+	CircularPipeline_init(&pipeline);
+	CircularPipeline_addStage(&pipeline, &rings[0], &rings[1], Demo_increment, NULL);
+	CircularPipeline_addStage(&pipeline, &rings[1], &rings[2], Demo_invert, NULL);
+	CircularPipeline_addStage(&pipeline, &rings[2], &rings[3], Demo_block, NULL);
+	if (!CircularPipeline_start(&pipeline, threads)) {
+		return 1;
+	}
+
+	// Feed a counting sequence and check it comes out transformed.
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	const double end = now.tv_sec + now.tv_nsec / 1e9 + seconds;
+	for (bool running = true; running || (received < (sent & ~(uint64_t)15)); ) {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		running = running && (now.tv_sec + now.tv_nsec / 1e9 < end);
+		if (running) {
+			uint16_t len = (uint16_t)(1 + rand() % sizeof(data));
+			for (uint16_t i = 0; i < len; i++) {
+				data[i] = (uint8_t)(sent + i);
+			}
+			sent += CircularBuffer_pushBack(&rings[0], data, len);
+		}
+		const uint16_t len = CircularBuffer_popFront(&rings[3], data, sizeof(data));
+		for (uint16_t i = 0; i < len; i++) {
+			failed |= (data[i] != (uint8_t)~(uint8_t)(received + i + 1));
+		}
+		received += len;
+		CircularPipeline_notify(&pipeline);
+		if (!len) {
+			usleep(100);
+		}
+	}
+	CircularPipeline_stop(&pipeline);
+
+	// Metrics.
+	printf("%u threads, %llu bytes through, %s\n", threads, (unsigned long long)received, failed ? "DATA ERROR" : "data ok");
+	printf("%-10s %10s %12s %12s %12s %12s %10s\n", "stage", "runs", "consumed", "produced", "in stalls", "out stalls", "busy ms");
+	for (uint16_t i = 0; i < 3; i++) {
+		CircularPipelineMetrics_t metrics;
+		CircularPipeline_getMetrics(&pipeline, i, &metrics);
+		printf("%-10s %10llu %12llu %12llu %12llu %12llu %10.1f\n", names[i], (unsigned long long)metrics.runs,
+			(unsigned long long)metrics.consumedBytes, (unsigned long long)metrics.producedBytes,
+			(unsigned long long)metrics.inputStalls, (unsigned long long)metrics.outputStalls, metrics.busyNanoseconds / 1e6);
+	}
+	return failed;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file      circularpooltest.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of circularpool.c. Checks exhaustion and refill on one thread, then hands sequence-numbered
+ *            blocks from a producer thread to a consumer thread by index through a message buffer. The producer
+ *            allocates and the consumer frees, so a block handed out twice while in flight is overwritten and caught.
+ * @usage     gcc -O2 -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularpooltest.c ../../../circularpool.c
+ *              ../../../circularbuffer.c -o circularpooltest
+ *            ./circularpooltest [blocks]
+ *            Add -fsanitize=thread for a ThreadSanitizer run.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularpool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+// Settings.
+#define TEST_BLOCK_COUNT 100
+#define TEST_BLOCK_WORDS 8
+#define TEST_MESSAGE_LENGTH 1001
+
+// Variables.
+static uint64_t blockMemory[TEST_BLOCK_COUNT][TEST_BLOCK_WORDS];
+static uint8_t freeListMemory[CIRCULARPOOL_FREELIST_LENGTH(TEST_BLOCK_COUNT)];
+static uint8_t messageMemory[TEST_MESSAGE_LENGTH];
+static CircularPool_t pool;
+static CircularBufferObject_t messages;
+static uint32_t total;
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message, const uint64_t sequence) {
+	if (!__atomic_exchange_n(&failed, true, __ATOMIC_RELAXED)) {
+		printf("FAIL: %s (block %llu)\n", message, (unsigned long long)sequence);
+	}
+}
+
+/*
+ * @brief Checks whether a check failed on either thread.
+ */
+static bool Test_failed(void) {
+	return __atomic_load_n(&failed, __ATOMIC_RELAXED);
+}
+
+/*
+ * @brief Allocates every block, checks the pool is then empty and frees them in reverse order.
+ */
+static void Test_exhaust(void) {
+	void * blocks[TEST_BLOCK_COUNT];
+	for (uint16_t i = 0; i < TEST_BLOCK_COUNT; i++) {
+		blocks[i] = CircularPool_alloc(&pool);
+		if (!blocks[i] || (CircularPool_at(&pool, CircularPool_indexOf(&pool, blocks[i])) != blocks[i])) {
+			Test_fail("alloc or index mapping failed", i);
+		}
+	}
+	if (CircularPool_alloc(&pool) || CircularPool_getFreeCount(&pool)) {
+		Test_fail("alloc succeeded on an empty pool", TEST_BLOCK_COUNT);
+	}
+	for (uint16_t i = TEST_BLOCK_COUNT; i--; ) {
+		CircularPool_free(&pool, blocks[i]);
+	}
+	if (CircularPool_getFreeCount(&pool) != TEST_BLOCK_COUNT) {
+		Test_fail("blocks missing after the refill", TEST_BLOCK_COUNT);
+	}
+}
+
+/*
+ * @brief Consumer thread, receives block indices, checks the payloads and frees the blocks.
+ */
+static void * Test_consumer(void * const argument) {
+	uint64_t sequence = 0;
+	(void)argument;
+
+	while ((sequence < total) && !Test_failed()) {
+		uint16_t index;
+		if (CircularBuffer_popFront(&messages, (uint8_t *)&index, sizeof(index)) != sizeof(index)) {
+			sched_yield();
+			continue;
+		}
+
+		// Every word carries the sequence number, a block reused while in flight shows a later one.
+		const uint64_t * const block = CircularPool_at(&pool, index);
+		for (uint16_t i = 0; i < TEST_BLOCK_WORDS; i++) {
+			if (block[i] != sequence + i) {
+				Test_fail("payload overwritten or out of order", sequence);
+			}
+		}
+		CircularPool_free(&pool, (void *)block);
+		sequence++;
+	}
+	return NULL;
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	total = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000UL;
+
+	// Single thread.
+	CircularPool_init(&pool, (uint8_t *)blockMemory, sizeof(blockMemory[0]), TEST_BLOCK_COUNT, freeListMemory);
+	Test_exhaust();
+
+	// Producer allocates and fills, the consumer frees.
+	CircularBuffer_initWithLength(&messages, messageMemory, sizeof(messageMemory));
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, Test_consumer, NULL);
+	for (uint64_t sequence = 0; (sequence < total) && !Test_failed(); ) {
+		uint64_t * const block = CircularPool_alloc(&pool);
+		if (!block) {
+			sched_yield();
+			continue;
+		}
+		for (uint16_t i = 0; i < TEST_BLOCK_WORDS; i++) {
+			block[i] = sequence + i;
+		}
+		const uint16_t index = CircularPool_indexOf(&pool, block);
+		while ((CircularBuffer_pushBack(&messages, (const uint8_t *)&index, sizeof(index)) != sizeof(index)) && !Test_failed()) {
+			sched_yield();
+		}
+		sequence++;
+	}
+	pthread_join(consumer, NULL);
+
+	// Every block is back.
+	if (CircularPool_getFreeCount(&pool) != TEST_BLOCK_COUNT) {
+		Test_fail("blocks missing after the handoff", total);
+	}
+
+	// Result.
+	if (!Test_failed()) {
+		printf("PASS: %u blocks handed off through a pool of %u\n", total, (unsigned)TEST_BLOCK_COUNT);
+	}
+	return Test_failed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
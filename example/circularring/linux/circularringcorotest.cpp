@@ -0,0 +1,148 @@
+/**
+ * @file      circularringcorotest.cpp
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of the coroutine awaitables of circus::Ring. A producer and a consumer coroutine on two threads
+ *            pass a sequence-numbered stream through a ring, each waiting with write_space() or read_at_least() and
+ *            resumed by the other side. Every byte is checked and a lost wakeup leaves a coroutine waiting.
+ * @usage     gcc -O2 -DCIRCULARBUFFER_SMP=1 -c ../../../circularbuffer.c -o circularbuffer.o
+ *            g++ -std=c++20 -O2 -pthread -DCIRCULARBUFFER_SMP=1 -I../../.. circularringcorotest.cpp circularbuffer.o
+ *              -o circularringcorotest
+ *            ./circularringcorotest [bytes]
+ *            Add -fsanitize=thread to both commands for a ThreadSanitizer run, -Wno-tsan silences the note that the
+ *            seq_cst fences of the wakeup are not modeled.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularbuffer.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// Settings.
+#define TEST_RING_LENGTH 1000
+#define TEST_MAX_WRITE 37
+#define TEST_MAX_READ 50
+
+// Fire-and-forget coroutine, runs on the calling thread until its first suspension.
+struct Test_task {
+	struct promise_type {
+		Test_task get_return_object() { return {}; }
+		std::suspend_never initial_suspend() { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+// Variables.
+static uint8_t ringMemory[TEST_RING_LENGTH];
+static circus::Ring ring(ringMemory, sizeof(ringMemory));
+static std::atomic<uint32_t> producedCount, consumedCount;
+static std::atomic<bool> failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message) {
+	if (!failed.exchange(true)) {
+		printf("FAIL: %s (produced %u, consumed %u)\n", message, producedCount.load(), consumedCount.load());
+	}
+}
+
+/*
+ * @brief Writes the sequence in chunks of varying size, waiting for space before each one.
+ */
+static Test_task Test_producer(const uint32_t total) {
+	uint8_t data[TEST_MAX_WRITE];
+	uint32_t sent = 0;
+	while ((sent < total) && !failed) {
+		uint16_t len = (uint16_t)(1 + sent % TEST_MAX_WRITE);
+		if (len > total - sent) {
+			len = (uint16_t)(total - sent);
+		}
+		if (co_await ring.write_space(len) < len) {
+			Test_fail("resumed without the requested space");
+		}
+		for (uint16_t i = 0; i < len; i++) {
+			data[i] = (uint8_t)(sent + i);
+		}
+		if (ring.push(data, len) != len) {
+			Test_fail("short push after the wait");
+		}
+		sent += len;
+		producedCount.store(sent);
+	}
+}
+
+/*
+ * @brief Reads the sequence in chunks of varying size, waiting for data before each one.
+ */
+static Test_task Test_consumer(const uint32_t total) {
+	uint8_t data[TEST_MAX_READ];
+	uint32_t got = 0;
+	while ((got < total) && !failed) {
+		uint16_t len = (uint16_t)(1 + got % TEST_MAX_READ);
+		if (len > total - got) {
+			len = (uint16_t)(total - got);
+		}
+		if (co_await ring.read_at_least(len) < len) {
+			Test_fail("resumed without the requested data");
+		}
+		if (ring.pop(data, len) != len) {
+			Test_fail("short pop after the wait");
+		}
+		for (uint16_t i = 0; i < len; i++) {
+			if (data[i] != (uint8_t)(got + i)) {
+				Test_fail("byte out of order");
+			}
+		}
+		got += len;
+		consumedCount.store(got);
+	}
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	const uint32_t total = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000UL;
+
+	// Each coroutine starts on its own thread and is later resumed inline by the thread of the other side, so both
+	// threads return once the coroutines have finished or are left waiting.
+	std::thread consumer([total] { Test_consumer(total); });
+	std::thread producer([total] { Test_producer(total); });
+	consumer.join();
+	producer.join();
+	if ((producedCount.load() != total) || (consumedCount.load() != total)) {
+		Test_fail("coroutine left waiting, wakeup lost");
+	}
+
+	// Result.
+	if (!failed) {
+		printf("PASS: %u bytes through a %u-byte ring\n", consumedCount.load(), (unsigned)TEST_RING_LENGTH);
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
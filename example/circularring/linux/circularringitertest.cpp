@@ -0,0 +1,139 @@
+/**
+ * @file      circularringitertest.cpp
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of the iterators and segments of circus::Ring against a std::vector model. Random pushes and
+ *            pops wrap the ring, and after each one the unread data must match the model through std::equal,
+ *            std::search, indexing, ranges::count and the concatenated segments.
+ * @usage     gcc -O2 -c ../../../circularbuffer.c -o circularbuffer.o
+ *            g++ -std=c++20 -O2 -I../../.. circularringitertest.cpp circularbuffer.o -o circularringitertest
+ *            ./circularringitertest [operations]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularbuffer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+// Settings.
+#define TEST_RING_LENGTH 1000
+#define TEST_MAX_OPERATION 100
+#define TEST_SYMBOLS 7
+
+// The iterator must work with the standard algorithms that need random access.
+static_assert(std::random_access_iterator<circus::Ring::const_iterator>);
+
+// Variables.
+static uint8_t ringMemory[TEST_RING_LENGTH];
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message, const uint32_t operation) {
+	if (!failed) {
+		printf("FAIL: %s (operation %u)\n", message, operation);
+	}
+	failed = true;
+}
+
+/*
+ * @brief Compares the unread data of the ring with the model.
+ */
+static void Test_compare(const circus::Ring & ring, const std::vector<uint8_t> & model, const uint32_t operation) {
+	// Whole range.
+	if ((ring.end() - ring.begin() != (std::ptrdiff_t)model.size())
+		|| !std::equal(ring.begin(), ring.end(), model.begin(), model.end())) {
+		Test_fail("iterator range differs", operation);
+	}
+
+	// Segments joined.
+	const auto segments = ring.segments();
+	std::vector<uint8_t> joined(segments[0].begin(), segments[0].end());
+	joined.insert(joined.end(), segments[1].begin(), segments[1].end());
+	if (joined != model) {
+		Test_fail("segments differ", operation);
+	}
+
+	// Search, the short alphabet makes the pattern appear often and across the wrap.
+	static const uint8_t pattern[] = {3, 4, 5};
+	const auto found = std::search(ring.begin(), ring.end(), std::begin(pattern), std::end(pattern));
+	const auto expected = std::search(model.begin(), model.end(), std::begin(pattern), std::end(pattern));
+	if ((found - ring.begin()) != (expected - model.begin())) {
+		Test_fail("search differs", operation);
+	}
+
+	// Random access from both ends.
+	if (!model.empty()) {
+		const size_t index = (size_t)rand() % model.size();
+		if ((ring.begin()[(std::ptrdiff_t)index] != model[index]) || (*(ring.end() - 1) != model.back())) {
+			Test_fail("indexing differs", operation);
+		}
+	}
+
+	// Ranges.
+	if ((size_t)std::ranges::count(std::ranges::subrange(ring.begin(), ring.end()), 3) != (size_t)std::ranges::count(model, 3)) {
+		Test_fail("ranges::count differs", operation);
+	}
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	const uint32_t operations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 200000UL;
+	circus::Ring ring(ringMemory, sizeof(ringMemory));
+	std::vector<uint8_t> model;
+	uint8_t data[TEST_MAX_OPERATION];
+
+	// Random pushes and pops, the model takes what the ring accepted or returned.
+	srand(1);
+	for (uint32_t i = 0; (i < operations) && !failed; i++) {
+		const uint16_t len = (uint16_t)(rand() % TEST_MAX_OPERATION);
+		if (rand() & 1) {
+			for (uint16_t j = 0; j < len; j++) {
+				data[j] = (uint8_t)(rand() % TEST_SYMBOLS);
+			}
+			const uint16_t pushed = ring.push(data, len);
+			model.insert(model.end(), data, data + pushed);
+		} else {
+			const uint16_t popped = ring.pop(data, len);
+			if (!std::equal(data, data + popped, model.begin(), model.begin() + popped)) {
+				Test_fail("popped data differs", i);
+			}
+			model.erase(model.begin(), model.begin() + popped);
+		}
+		Test_compare(ring, model, i);
+	}
+
+	// Result.
+	if (!failed) {
+		printf("PASS: %u operations on a %u-byte ring\n", operations, (unsigned)TEST_RING_LENGTH);
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
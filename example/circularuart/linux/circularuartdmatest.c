@@ -0,0 +1,221 @@
+/**
+ * @file      circularuartdmatest.c
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host test of the tx DMA path of circularuart.c against a simulated DMA channel. Random sends race the
+ *            transfers, every byte that leaves the channel is checked against the sent stream, and the transfers
+ *            must stay within the buffer memory and chain across the wrap. A receive with flow control must not
+ *            wait beyond the high watermark.
+ * @usage     gcc -O2 -I. -I../stm32f10x -I../../.. -DCIRCULARUART_TX_DMA=1 -DCIRCULARUART_VECTORS=0 circularuartdmatest.c
+ *              ../stm32f10x/circularuart.c ../../../circularframe.c ../../../circularbuffer.c -o circularuartdmatest
+ *            ./circularuartdmatest [iterations]
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Includes.
+#include "circularuart.h"
+#include <stm32f10x.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Settings.
+#define TEST_LENGTH_2N 6
+#define TEST_MAX_SEND 40
+
+// Peripherals.
+USART_TypeDef FakeUSART[5];
+DMA_Channel_TypeDef FakeDMAChannel[4];
+GPIO_TypeDef FakeGPIO[4];
+
+// Variables.
+static CircularUART_t uart;
+static uint8_t txMemory[1UL << TEST_LENGTH_2N];
+static uint8_t rxMemory[1UL << TEST_LENGTH_2N];
+static uint32_t pendingComplete;
+static bool dmaIrqMasked;
+static uint32_t dmaDone;
+static uint32_t sentCount, receivedCount, transferCount, wrapChainCount;
+static bool failed;
+
+/*
+ * @brief Reports a failed check.
+ */
+static void Test_fail(const char * const message) {
+	if (!failed) {
+		printf("FAIL: %s (sent %u, received %u, transfers %u)\n", message, sentCount, receivedCount, transferCount);
+	}
+	failed = true;
+}
+
+/*
+ * @brief Gets the memory address a channel was programmed with, the register holds its low 32 bits.
+ */
+static const uint8_t * Test_channelMemory(const DMA_Channel_TypeDef * const channel) {
+	return (const uint8_t *)(((uintptr_t)txMemory & ~(uintptr_t)0xFFFFFFFFUL) | channel->CMAR);
+}
+
+/*
+ * @brief Moves up to maxlen bytes through the enabled channel of USART2 and raises transfer-complete at the end.
+ */
+static void Test_runDma(uint32_t maxlen) {
+	DMA_Channel_TypeDef * const channel = DMA1_Channel7;
+
+	// Idle or already complete.
+	if (!(channel->CCR & DMA_CCR1_EN) || !channel->CNDTR) {
+		return;
+	}
+
+	// Move bytes to the USART, each one must be the next byte of the sent stream.
+	const uint8_t * const memory = Test_channelMemory(channel);
+	while (maxlen-- && channel->CNDTR) {
+		if (memory[dmaDone++] != (uint8_t)(receivedCount * 7 + 3)) {
+			Test_fail("byte out of order");
+		}
+		receivedCount++;
+		channel->CNDTR--;
+	}
+
+	// Transfer complete.
+	if (!channel->CNDTR) {
+		pendingComplete |= DMA1_IT_TC7;
+		if (dmaIrqMasked) {
+			Test_fail("transfer-complete masked outside of a send");
+		}
+		CircularUART_DMAIRQHandler(&uart);
+	}
+}
+
+/*
+ * @brief Runs the test.
+ */
+int main(int argc, char * argv[]) {
+	const uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000UL;
+	uint8_t data[TEST_MAX_SEND];
+
+	// Bind USART2, its tx DMA channel is DMA1 channel 7.
+	srand(1);
+	CircularUART_Init(&uart, &CircularUART_USART2, 115200, 0);
+	CircularUART_StartTx(&uart, txMemory, TEST_LENGTH_2N);
+
+	// Sends of random sizes race transfers of random progress.
+	for (uint32_t i = 0; (i < iterations) && !failed; i++) {
+		const uint16_t len = (uint16_t)(1 + rand() % TEST_MAX_SEND);
+		for (uint16_t j = 0; j < len; j++) {
+			data[j] = (uint8_t)((sentCount + j) * 7 + 3);
+		}
+		sentCount += CircularUART_Send(&uart, data, len);
+		Test_runDma((uint32_t)(rand() % (2 * TEST_MAX_SEND)));
+	}
+
+	// Drain.
+	for (uint32_t i = 0; (i < 1000) && (receivedCount < sentCount) && !failed; i++) {
+		Test_runDma(TEST_MAX_SEND);
+	}
+	if (receivedCount != sentCount) {
+		Test_fail("bytes left in the tx buffer");
+	}
+	if (!wrapChainCount) {
+		Test_fail("no transfer was chained across the wrap");
+	}
+
+	// With flow control the peer stops at the high watermark, a larger minimum must not wait for more.
+	CircularUART_StartRx(&uart, rxMemory, TEST_LENGTH_2N);
+	if (!CircularUART_EnableFlowControl(&uart, 30, 10)) {
+		Test_fail("flow control not enabled");
+	}
+	for (uint16_t j = 0; j < 30; j++) {
+		data[j] = (uint8_t)j;
+	}
+	CircularBuffer_pushBack(&uart.rxBufferObject, data, 30);
+	if (CircularUART_ReceiveTimed(&uart, data, TEST_MAX_SEND, TEST_MAX_SEND, 0) != 30) {
+		Test_fail("receive not limited to the high watermark");
+	}
+
+	// Result.
+	if (!failed) {
+		printf("PASS: %u bytes in %u transfers, %u chained across the wrap\n", receivedCount, transferCount, wrapChainCount);
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * @brief Enables or disables a channel. On enable checks the transfer against the buffer memory.
+ */
+void DMA_Cmd(DMA_Channel_TypeDef * DMAy_Channelx, FunctionalState NewState) {
+	static const uint8_t * lastEnd;
+	if (NewState == DISABLE) {
+		DMAy_Channelx->CCR &= ~DMA_CCR1_EN;
+		return;
+	}
+	DMAy_Channelx->CCR |= DMA_CCR1_EN;
+	dmaDone = 0;
+	transferCount++;
+
+	// A transfer is a span within the memory, the one after the end of the memory starts at its beginning.
+	const uint8_t * const start = Test_channelMemory(DMAy_Channelx);
+	if (!DMAy_Channelx->CNDTR || (start < txMemory) || (start + DMAy_Channelx->CNDTR > txMemory + sizeof(txMemory))) {
+		Test_fail("transfer outside of the buffer memory");
+	}
+	if ((lastEnd == txMemory + sizeof(txMemory)) && (start == txMemory)) {
+		wrapChainCount++;
+	}
+	lastEnd = start + DMAy_Channelx->CNDTR;
+}
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT) {
+	return (pendingComplete & DMAy_IT) ? SET : RESET;
+}
+void DMA_ClearITPendingBit(uint32_t DMAy_IT) {
+	pendingComplete &= ~DMAy_IT;
+}
+void NVIC_DisableIRQ(IRQn_Type IRQn) {
+	if (IRQn == DMA1_Channel7_IRQn) {
+		dmaIrqMasked = true;
+	}
+}
+void NVIC_EnableIRQ(IRQn_Type IRQn) {
+	if (IRQn == DMA1_Channel7_IRQn) {
+		dmaIrqMasked = false;
+	}
+}
+
+// Peripherals without behavior in this test.
+void GPIO_Init(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_InitStruct) { (void)GPIOx; (void)GPIO_InitStruct; }
+void GPIO_SetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void GPIO_ResetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin) { (void)GPIOx; (void)GPIO_Pin; }
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) { (void)RCC_APB1Periph; (void)NewState; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) { (void)RCC_APB2Periph; (void)NewState; }
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState) { (void)RCC_AHBPeriph; (void)NewState; }
+void NVIC_Init(NVIC_InitTypeDef * NVIC_InitStruct) { (void)NVIC_InitStruct; }
+void USART_Init(USART_TypeDef * USARTx, USART_InitTypeDef * USART_InitStruct) { (void)USARTx; (void)USART_InitStruct; }
+void USART_Cmd(USART_TypeDef * USARTx, FunctionalState NewState) { (void)USARTx; (void)NewState; }
+void USART_ITConfig(USART_TypeDef * USARTx, uint16_t USART_IT, FunctionalState NewState) { (void)USARTx; (void)USART_IT; (void)NewState; }
+void USART_DMACmd(USART_TypeDef * USARTx, uint16_t USART_DMAReq, FunctionalState NewState) { (void)USARTx; (void)USART_DMAReq; (void)NewState; }
+void USART_SendData(USART_TypeDef * USARTx, uint16_t Data) { (void)USARTx; (void)Data; }
+uint16_t USART_ReceiveData(USART_TypeDef * USARTx) { (void)USARTx; return 0; }
+FlagStatus USART_GetFlagStatus(USART_TypeDef * USARTx, uint16_t USART_FLAG) { (void)USARTx; (void)USART_FLAG; return RESET; }
+void USART_ClearFlag(USART_TypeDef * USARTx, uint16_t USART_FLAG) { (void)USARTx; (void)USART_FLAG; }
+ITStatus USART_GetITStatus(USART_TypeDef * USARTx, uint16_t USART_IT) { (void)USARTx; (void)USART_IT; return RESET; }
+void DMA_DeInit(DMA_Channel_TypeDef * DMAy_Channelx) { memset((void *)DMAy_Channelx, 0, sizeof(*DMAy_Channelx)); }
+void DMA_Init(DMA_Channel_TypeDef * DMAy_Channelx, DMA_InitTypeDef * DMA_InitStruct) { (void)DMAy_Channelx; (void)DMA_InitStruct; }
+void DMA_ITConfig(DMA_Channel_TypeDef * DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState) { (void)DMAy_Channelx; (void)DMA_IT; (void)NewState; }
+uint32_t CircularUART_GetTick(void) { return 0; }
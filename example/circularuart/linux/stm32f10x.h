@@ -0,0 +1,180 @@
+/**
+ * @file      stm32f10x.h
+ * @author    Atakan S.
+ * @date      16/10/2026
+ * @version   1.0
+ * @brief     Host stand-in for the STM32F10x device header and standard peripheral library, just enough to build
+ *            circularuart.c on a PC. The peripheral functions are implemented by the test that links it.
+ *
+ * @copyright Copyright (c) 2018 Atakan SARIOGLU ~ www.atakansarioglu.com
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ */
+
+// Protection.
+#ifndef _H_STM32F10X
+#define _H_STM32F10X
+
+// Includes.
+#include <stdint.h>
+
+// Type definitions.
+typedef enum {DISABLE = 0, ENABLE = 1} FunctionalState;
+typedef enum {RESET = 0, SET = 1} FlagStatus, ITStatus;
+typedef enum {
+	DMA1_Channel2_IRQn = 12, DMA1_Channel4_IRQn = 14, DMA1_Channel7_IRQn = 17,
+	USART1_IRQn = 37, USART2_IRQn = 38, USART3_IRQn = 39, UART4_IRQn = 52, UART5_IRQn = 53,
+	DMA2_Channel4_5_IRQn = 59
+}IRQn_Type;
+typedef struct{
+	volatile uint16_t SR, RESERVED0, DR, RESERVED1, BRR, RESERVED2, CR1, RESERVED3, CR2, RESERVED4, CR3, RESERVED5, GTPR, RESERVED6;
+}USART_TypeDef;
+typedef struct{
+	volatile uint32_t CCR, CNDTR, CPAR, CMAR;
+}DMA_Channel_TypeDef;
+typedef struct{
+	volatile uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR;
+}GPIO_TypeDef;
+typedef struct{
+	uint16_t GPIO_Pin;
+	uint32_t GPIO_Speed;
+	uint32_t GPIO_Mode;
+}GPIO_InitTypeDef;
+typedef struct{
+	uint32_t USART_BaudRate;
+	uint16_t USART_WordLength, USART_StopBits, USART_Parity, USART_Mode, USART_HardwareFlowControl;
+}USART_InitTypeDef;
+typedef struct{
+	uint8_t NVIC_IRQChannel, NVIC_IRQChannelPreemptionPriority, NVIC_IRQChannelSubPriority;
+	FunctionalState NVIC_IRQChannelCmd;
+}NVIC_InitTypeDef;
+typedef struct{
+	uint32_t DMA_PeripheralBaseAddr, DMA_MemoryBaseAddr, DMA_DIR, DMA_BufferSize, DMA_PeripheralInc, DMA_MemoryInc;
+	uint32_t DMA_PeripheralDataSize, DMA_MemoryDataSize, DMA_Mode, DMA_Priority, DMA_M2M;
+}DMA_InitTypeDef;
+
+// Peripherals.
+extern USART_TypeDef FakeUSART[5];
+extern DMA_Channel_TypeDef FakeDMAChannel[4];
+extern GPIO_TypeDef FakeGPIO[4];
+#define USART1 (&FakeUSART[0])
+#define USART2 (&FakeUSART[1])
+#define USART3 (&FakeUSART[2])
+#define UART4 (&FakeUSART[3])
+#define UART5 (&FakeUSART[4])
+#define DMA1_Channel4 (&FakeDMAChannel[0])
+#define DMA1_Channel7 (&FakeDMAChannel[1])
+#define DMA1_Channel2 (&FakeDMAChannel[2])
+#define DMA2_Channel5 (&FakeDMAChannel[3])
+#define GPIOA (&FakeGPIO[0])
+#define GPIOB (&FakeGPIO[1])
+#define GPIOC (&FakeGPIO[2])
+#define GPIOD (&FakeGPIO[3])
+
+// Constants.
+#define GPIO_Pin_0 0x0001
+#define GPIO_Pin_1 0x0002
+#define GPIO_Pin_2 0x0004
+#define GPIO_Pin_3 0x0008
+#define GPIO_Pin_9 0x0200
+#define GPIO_Pin_10 0x0400
+#define GPIO_Pin_11 0x0800
+#define GPIO_Pin_12 0x1000
+#define GPIO_Pin_13 0x2000
+#define GPIO_Pin_14 0x4000
+#define GPIO_Mode_IN_FLOATING 0x04
+#define GPIO_Mode_AF_PP 0x18
+#define GPIO_Mode_Out_PP 0x10
+#define GPIO_Mode_IPU 0x48
+#define GPIO_Speed_50MHz 3
+#define USART_WordLength_8b 0x0000
+#define USART_StopBits_1 0x0000
+#define USART_Parity_No 0x0000
+#define USART_Parity_Even 0x0400
+#define USART_Parity_Odd 0x0600
+#define USART_HardwareFlowControl_None 0x0000
+#define USART_Mode_Rx 0x0004
+#define USART_Mode_Tx 0x0008
+#define USART_IT_RXNE 0x0525
+#define USART_IT_TXE 0x0727
+#define USART_FLAG_RXNE 0x0020
+#define USART_FLAG_TC 0x0040
+#define USART_FLAG_TXE 0x0080
+#define USART_DMAReq_Tx 0x0080
+#define USART_CR3_CTSE 0x0200
+#define RCC_APB2Periph_AFIO 0x00000001
+#define RCC_APB2Periph_GPIOA 0x00000004
+#define RCC_APB2Periph_GPIOB 0x00000008
+#define RCC_APB2Periph_GPIOC 0x00000010
+#define RCC_APB2Periph_GPIOD 0x00000020
+#define RCC_APB2Periph_USART1 0x00004000
+#define RCC_APB1Periph_USART2 0x00020000
+#define RCC_APB1Periph_USART3 0x00040000
+#define RCC_APB1Periph_UART4 0x00080000
+#define RCC_APB1Periph_UART5 0x00100000
+#define RCC_AHBPeriph_DMA1 0x00000001
+#define RCC_AHBPeriph_DMA2 0x00000002
+#define DMA_DIR_PeripheralDST 0x00000010
+#define DMA_PeripheralInc_Disable 0x00000000
+#define DMA_MemoryInc_Enable 0x00000080
+#define DMA_PeripheralDataSize_Byte 0x00000000
+#define DMA_MemoryDataSize_Byte 0x00000000
+#define DMA_Mode_Normal 0x00000000
+#define DMA_Priority_Medium 0x00001000
+#define DMA_M2M_Disable 0x00000000
+#define DMA_IT_TC 0x00000002
+#define DMA_CCR1_EN 0x00000001
+#define DMA1_IT_TC2 0x00000020
+#define DMA1_IT_TC4 0x00002000
+#define DMA1_IT_TC7 0x02000000
+#define DMA2_IT_TC5 0x10020000
+
+// Core.
+#define __WFI() ((void)0)
+#define __disable_irq() ((void)0)
+#define __get_PRIMASK() 0U
+#define __set_PRIMASK(primask) ((void)(primask))
+
+// Peripheral library.
+void GPIO_Init(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_InitStruct);
+void GPIO_SetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin);
+void GPIO_ResetBits(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin);
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState);
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState);
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState);
+void NVIC_Init(NVIC_InitTypeDef * NVIC_InitStruct);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void USART_Init(USART_TypeDef * USARTx, USART_InitTypeDef * USART_InitStruct);
+void USART_Cmd(USART_TypeDef * USARTx, FunctionalState NewState);
+void USART_ITConfig(USART_TypeDef * USARTx, uint16_t USART_IT, FunctionalState NewState);
+void USART_DMACmd(USART_TypeDef * USARTx, uint16_t USART_DMAReq, FunctionalState NewState);
+void USART_SendData(USART_TypeDef * USARTx, uint16_t Data);
+uint16_t USART_ReceiveData(USART_TypeDef * USARTx);
+FlagStatus USART_GetFlagStatus(USART_TypeDef * USARTx, uint16_t USART_FLAG);
+void USART_ClearFlag(USART_TypeDef * USARTx, uint16_t USART_FLAG);
+ITStatus USART_GetITStatus(USART_TypeDef * USARTx, uint16_t USART_IT);
+void DMA_DeInit(DMA_Channel_TypeDef * DMAy_Channelx);
+void DMA_Init(DMA_Channel_TypeDef * DMAy_Channelx, DMA_InitTypeDef * DMA_InitStruct);
+void DMA_Cmd(DMA_Channel_TypeDef * DMAy_Channelx, FunctionalState NewState);
+void DMA_ITConfig(DMA_Channel_TypeDef * DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState);
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT);
+void DMA_ClearITPendingBit(uint32_t DMAy_IT);
+
+#endif
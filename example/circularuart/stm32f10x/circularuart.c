@@ -30,137 +30,434 @@
 // Includes.
 #include "circularuart.h"
 #include "circularbuffer.h"
+#include "circularframe.h"
 #include <stm32f10x.h>
+#include <stddef.h>
 
 // Settings.
-#ifndef IRQPRIORITY_USART1
-#define IRQPRIORITY_USART1 0
+#ifndef IRQPRIORITY_CIRCULARUART
+#define IRQPRIORITY_CIRCULARUART 0
+#endif
+#ifndef IRQPRIORITY_CIRCULARUART_DMA
+#define IRQPRIORITY_CIRCULARUART_DMA IRQPRIORITY_CIRCULARUART
+#endif
+#ifndef CIRCULARUART_TX_DMA
+#define CIRCULARUART_TX_DMA 0
+#endif
+#ifndef CIRCULARUART_VECTORS
+#define CIRCULARUART_VECTORS 1
+#endif
+#ifndef CIRCULARUART_GETTICK
+#define CIRCULARUART_GETTICK() CircularUART_GetTick()
+#endif
+// Sleeps unless the rx buffer no longer holds the unread size that was seen. The default sleeps with interrupts
+// masked, so a byte arriving after the check still wakes the core.
+#ifndef CIRCULARUART_IDLE
+#define CIRCULARUART_IDLE(bufferObject, unread) do { \
+		const uint32_t primask = __get_PRIMASK(); \
+		__disable_irq(); \
+		if (CircularBuffer_getUnreadSize(bufferObject) == (unread)) { \
+			__WFI(); \
+		} \
+		__set_PRIMASK(primask); \
+	} while (0)
+#endif
+
+// Port count.
+#if defined(STM32F10X_HD) || defined(STM32F10X_XL) || defined(STM32F10X_HD_VL) || defined(STM32F10X_CL)
+#define CIRCULARUART_PORT_COUNT 5
+#else
+#define CIRCULARUART_PORT_COUNT 3
+#endif
+
+// Connectivity line devices have a separate vector for DMA2 channel 5.
+#if defined(STM32F10X_CL)
+#define CIRCULARUART_DMA2_CHANNEL5_IRQN DMA2_Channel5_IRQn
+#else
+#define CIRCULARUART_DMA2_CHANNEL5_IRQN DMA2_Channel4_5_IRQn
+#endif
+
+// Hardware binding of a port.
+struct CircularUARTPort_s{
+	USART_TypeDef * usart;
+	IRQn_Type irq;
+	uint32_t clockAPB1;
+	uint32_t clockAPB2;
+	GPIO_TypeDef * txGpio;
+	uint16_t txPin;
+	GPIO_TypeDef * rxGpio;
+	uint16_t rxPin;
+	uint32_t gpioClock;
+	GPIO_TypeDef * rtsGpio;
+	uint16_t rtsPin;
+	GPIO_TypeDef * ctsGpio;
+	uint16_t ctsPin;
+	DMA_Channel_TypeDef * txDmaChannel;
+	IRQn_Type txDmaIrq;
+	uint32_t txDmaClock;
+	uint32_t txDmaComplete;
+	uint8_t index;
+};
+
+// Ports.
+const CircularUARTPort_t CircularUART_USART1 = {
+	USART1, USART1_IRQn, 0, RCC_APB2Periph_USART1,
+	GPIOA, GPIO_Pin_9, GPIOA, GPIO_Pin_10, RCC_APB2Periph_GPIOA,
+	GPIOA, GPIO_Pin_12, GPIOA, GPIO_Pin_11,
+	DMA1_Channel4, DMA1_Channel4_IRQn, RCC_AHBPeriph_DMA1, DMA1_IT_TC4, 0
+};
+const CircularUARTPort_t CircularUART_USART2 = {
+	USART2, USART2_IRQn, RCC_APB1Periph_USART2, 0,
+	GPIOA, GPIO_Pin_2, GPIOA, GPIO_Pin_3, RCC_APB2Periph_GPIOA,
+	GPIOA, GPIO_Pin_1, GPIOA, GPIO_Pin_0,
+	DMA1_Channel7, DMA1_Channel7_IRQn, RCC_AHBPeriph_DMA1, DMA1_IT_TC7, 1
+};
+const CircularUARTPort_t CircularUART_USART3 = {
+	USART3, USART3_IRQn, RCC_APB1Periph_USART3, 0,
+	GPIOB, GPIO_Pin_10, GPIOB, GPIO_Pin_11, RCC_APB2Periph_GPIOB,
+	GPIOB, GPIO_Pin_14, GPIOB, GPIO_Pin_13,
+	DMA1_Channel2, DMA1_Channel2_IRQn, RCC_AHBPeriph_DMA1, DMA1_IT_TC2, 2
+};
+#if CIRCULARUART_PORT_COUNT > 3
+const CircularUARTPort_t CircularUART_UART4 = {
+	UART4, UART4_IRQn, RCC_APB1Periph_UART4, 0,
+	GPIOC, GPIO_Pin_10, GPIOC, GPIO_Pin_11, RCC_APB2Periph_GPIOC,
+	NULL, 0, NULL, 0,
+	DMA2_Channel5, CIRCULARUART_DMA2_CHANNEL5_IRQN, RCC_AHBPeriph_DMA2, DMA2_IT_TC5, 3
+};
+const CircularUARTPort_t CircularUART_UART5 = {
+	UART5, UART5_IRQn, RCC_APB1Periph_UART5, 0,
+	GPIOC, GPIO_Pin_12, GPIOD, GPIO_Pin_2, RCC_APB2Periph_GPIOC | RCC_APB2Periph_GPIOD,
+	NULL, 0, NULL, 0,
+	NULL, (IRQn_Type)0, 0, 0, 4
+};
 #endif
 
 // Variables.
-static CircularBufferObject_t rxBufferObject, txBufferObject;
+static CircularUART_t * instances[CIRCULARUART_PORT_COUNT];
+
+/*
+ * @brief Drives RTS from the rx buffer occupancy.
+ * @param bufferObject The rx buffer object of a port handle.
+ * @param high True if the high watermark was reached, false if the low watermark was reached.
+ */
+static void CircularUART_RxWatermark(CircularBufferObject_t * const bufferObject, const bool high) {
+	const CircularUART_t * const uart = (const CircularUART_t *)((uint8_t *)bufferObject - offsetof(CircularUART_t, rxBufferObject));
+
+	// RTS is active low, de-assert to stop the peer and re-assert to resume.
+	if (high) {
+		GPIO_SetBits(uart->port->rtsGpio, uart->port->rtsPin);
+	} else {
+		GPIO_ResetBits(uart->port->rtsGpio, uart->port->rtsPin);
+	}
+}
+
+#if CIRCULARUART_TX_DMA
+/*
+ * @brief Starts a DMA transfer over the contiguous unread span of the tx buffer unless a transfer is in progress.
+ * @param uart The port handle.
+ */
+static void CircularUART_StartTxDma(CircularUART_t * const uart) {
+	// Transfer in progress, transfer-complete interrupt chains the next span.
+	if (uart->txDmaLength) {
+		return;
+	}
+
+	// Get the largest span that can be sent without wrapping.
+	const uint8_t * span;
+	uint16_t len = CircularBuffer_getFrontSpan(&uart->txBufferObject, &span);
+
+	// Start the transfer.
+	if (len) {
+		DMA_Channel_TypeDef * const channel = uart->port->txDmaChannel;
+		uart->txDmaLength = len;
+		DMA_Cmd(channel, DISABLE);
+		channel->CMAR = (uint32_t)(uintptr_t)span;
+		channel->CNDTR = len;
+		DMA_Cmd(channel, ENABLE);
+	}
+}
+
+/*
+ * @brief Stops the DMA transfer and discards the in-flight span.
+ * @param uart The port handle.
+ */
+static void CircularUART_StopTxDma(CircularUART_t * const uart) {
+	// Disable the channel, no transfer-complete interrupt follows.
+	if (uart->port->txDmaChannel) {
+		DMA_Cmd(uart->port->txDmaChannel, DISABLE);
+		DMA_ClearITPendingBit(uart->port->txDmaComplete);
+	}
+	uart->txDmaLength = 0;
+}
+#endif
 
 /*
  * @brief Initializes UART hardware with the given baud-rate.
+ * @param uart The port handle.
+ * @param port The hardware port to bind, i.e. &CircularUART_USART1.
  * @param baud The baud-rate to set.
  * @param parity Parity setting. 0 for no-parity, 1 for odd and 2 for even.
  */
-void CircularUART_Init(const uint32_t baud, const uint8_t parity) {
+void CircularUART_Init(CircularUART_t * const uart, const CircularUARTPort_t * const port, const uint32_t baud, const uint8_t parity) {
 	GPIO_InitTypeDef GPIO_InitStructure;
 	USART_InitTypeDef USART_InitStructure;
 	NVIC_InitTypeDef NVIC_InitStructure;
+#if CIRCULARUART_TX_DMA
+	DMA_InitTypeDef DMA_InitStructure;
+#endif
+
+	// Bind the port.
+	uart->port = port;
+	uart->txDmaLength = 0;
+	instances[port->index] = uart;
 
 	// Reset the buffers.
-	CircularBuffer_init(&rxBufferObject, NULL, 0);
-	CircularBuffer_init(&txBufferObject, NULL, 0);
+	CircularBuffer_init(&uart->rxBufferObject, NULL, 0);
+	CircularBuffer_init(&uart->txBufferObject, NULL, 0);
 
 	// GPIO clock enable.
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_AFIO, ENABLE);
+	RCC_APB2PeriphClockCmd(port->gpioClock | RCC_APB2Periph_AFIO, ENABLE);
 
-	// Enable USART1 clock.
-	RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, ENABLE);
+	// Enable USART clock.
+	if (port->clockAPB2) {
+		RCC_APB2PeriphClockCmd(port->clockAPB2, ENABLE);
+	}
+	if (port->clockAPB1) {
+		RCC_APB1PeriphClockCmd(port->clockAPB1, ENABLE);
+	}
 
 	// Configure Rx as input floating.
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;
+	GPIO_InitStructure.GPIO_Pin = port->rxPin;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	GPIO_Init(port->rxGpio, &GPIO_InitStructure);
 
 	// Configure Tx as alternate function push-pull.
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_9;
+	GPIO_InitStructure.GPIO_Pin = port->txPin;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
-	GPIO_Init(GPIOA, &GPIO_InitStructure);
+	GPIO_Init(port->txGpio, &GPIO_InitStructure);
 
-	// Enable USART1 interrupts.
-	NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQPRIORITY_USART1;
+	// Enable USART interrupts.
+	NVIC_InitStructure.NVIC_IRQChannel = port->irq;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQPRIORITY_CIRCULARUART;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
 
-	// Configure USART1 as 8bit UART with no parity.
+	// Configure USART as 8bit UART with no parity.
 	USART_InitStructure.USART_BaudRate = baud;
 	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
 	USART_InitStructure.USART_StopBits = USART_StopBits_1;
 	USART_InitStructure.USART_Parity = ((!parity) ? USART_Parity_No : ((parity == 1) ? USART_Parity_Odd : USART_Parity_Even));
 	USART_InitStructure.USART_HardwareFlowControl =	USART_HardwareFlowControl_None;
 	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
-	USART_Init(USART1, &USART_InitStructure);
+	USART_Init(port->usart, &USART_InitStructure);
+
+	// Disable the USART transmit buffer empty interrupt.
+	USART_ITConfig(port->usart, USART_IT_TXE, DISABLE);
+
+	// Disable the USART receive buffer not empty interrupt.
+	USART_ITConfig(port->usart, USART_IT_RXNE, DISABLE);
+
+#if CIRCULARUART_TX_DMA
+	// Ports without a tx DMA channel fall back to interrupt-driven transmission.
+	if (port->txDmaChannel) {
+		// Enable DMA clock.
+		RCC_AHBPeriphClockCmd(port->txDmaClock, ENABLE);
 
-	// Disable the USART1 transmit buffer empty interrupt.
-	USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+		// Configure the channel for memory to USART transfers, the span is set per transfer.
+		DMA_DeInit(port->txDmaChannel);
+		DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&port->usart->DR;
+		DMA_InitStructure.DMA_MemoryBaseAddr = 0;
+		DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+		DMA_InitStructure.DMA_BufferSize = 0;
+		DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+		DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+		DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+		DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+		DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+		DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+		DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+		DMA_Init(port->txDmaChannel, &DMA_InitStructure);
 
-	// Disable the USART1 receive buffer not empty interrupt.
-	USART_ITConfig(USART1, USART_IT_RXNE, DISABLE);
+		// Enable the transfer-complete interrupt.
+		DMA_ITConfig(port->txDmaChannel, DMA_IT_TC, ENABLE);
+		NVIC_InitStructure.NVIC_IRQChannel = port->txDmaIrq;
+		NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQPRIORITY_CIRCULARUART_DMA;
+		NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+		NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+		NVIC_Init(&NVIC_InitStructure);
 
-	// Enable USART1.
-	USART_Cmd(USART1, ENABLE);
+		// Let USART request tx data from DMA.
+		USART_DMACmd(port->usart, USART_DMAReq_Tx, ENABLE);
+	}
+#endif
+
+	// Enable USART.
+	USART_Cmd(port->usart, ENABLE);
 }
 
 /*
  * @brief Initializes and enables TX.
+ * @param uart The port handle.
  * @param buffer Memory buffer to use for tx circular buffer.
  * @param length_2N Size of the buffer memory, i.e. 8 indicates 2^8=256 bytes.
  */
-void CircularUART_StartTx(uint8_t * const buffer, const uint8_t length_2N) {
-	// Disable the USART1 transmit buffer empty interrupt.
-	USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+void CircularUART_StartTx(CircularUART_t * const uart, uint8_t * const buffer, const uint8_t length_2N) {
+	// Disable the USART transmit buffer empty interrupt.
+	USART_ITConfig(uart->port->usart, USART_IT_TXE, DISABLE);
+#if CIRCULARUART_TX_DMA
+	CircularUART_StopTxDma(uart);
+#endif
 
 	// Initialize the buffer.
-	CircularBuffer_init(&txBufferObject, buffer, length_2N);
+	CircularBuffer_init(&uart->txBufferObject, buffer, length_2N);
 }
 
 /*
  * @brief Initializes and enables RX.
+ * @param uart The port handle.
  * @param buffer Memory buffer to use for rx circular buffer.
  * @param length_2N Size of the buffer memory, i.e. 8 indicates 2^8=256 bytes.
  */
-void CircularUART_StartRx(uint8_t * const buffer, const uint8_t length_2N) {
-	//-- Disable the USART1 receive buffer not empty interrupt.
-	USART_ITConfig(USART1, USART_IT_RXNE, DISABLE);
+void CircularUART_StartRx(CircularUART_t * const uart, uint8_t * const buffer, const uint8_t length_2N) {
+	//-- Disable the USART receive buffer not empty interrupt.
+	USART_ITConfig(uart->port->usart, USART_IT_RXNE, DISABLE);
 
-	// Initialize the buffer.
-	CircularBuffer_init(&rxBufferObject, buffer, length_2N);
+	// Initialize the buffer, keeping the flow control watermarks.
+	const uint16_t highWatermark = uart->rxBufferObject.highWatermark;
+	const uint16_t lowWatermark = uart->rxBufferObject.lowWatermark;
+	const CircularBufferWatermarkCallback_t watermarkCallback = uart->rxBufferObject.watermarkCallback;
+	CircularBuffer_init(&uart->rxBufferObject, buffer, length_2N);
+	if (watermarkCallback) {
+		CircularBuffer_setWatermarks(&uart->rxBufferObject, highWatermark, lowWatermark, watermarkCallback);
+		GPIO_ResetBits(uart->port->rtsGpio, uart->port->rtsPin);
+	}
 
 	//-- Clear the RXNE bit to prevent outdated data.
-	USART_ClearFlag(USART1, USART_FLAG_RXNE);
+	USART_ClearFlag(uart->port->usart, USART_FLAG_RXNE);
+
+	//-- Enable the USART receive buffer not empty interrupt.
+	USART_ITConfig(uart->port->usart, USART_IT_RXNE, ENABLE);
+}
+
+/*
+ * @brief Enables RTS/CTS hardware flow control. RTS is de-asserted when the rx buffer occupancy reaches the high
+ *        watermark and re-asserted when it drops to the low watermark, CTS gates the transmitter.
+ * @param uart The port handle.
+ * @param high The rx buffer high watermark in bytes, leave room for the bytes the peer sends after RTS.
+ * @param low The rx buffer low watermark in bytes.
+ * @return Returns false if the port has no flow control pins.
+ */
+bool CircularUART_EnableFlowControl(CircularUART_t * const uart, const uint16_t high, const uint16_t low) {
+	GPIO_InitTypeDef GPIO_InitStructure;
+	const CircularUARTPort_t * const port = uart->port;
+
+	// Port check.
+	if (!port->rtsGpio || !port->ctsGpio) {
+		return false;
+	}
 
-	//-- Enable the USART1 receive buffer not empty interrupt.
-	USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+	// Configure RTS as push-pull output driven by software, asserted.
+	GPIO_ResetBits(port->rtsGpio, port->rtsPin);
+	GPIO_InitStructure.GPIO_Pin = port->rtsPin;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
+	GPIO_Init(port->rtsGpio, &GPIO_InitStructure);
+
+	// Configure CTS as input with pull-up, i.e. the peer stops us when disconnected.
+	GPIO_InitStructure.GPIO_Pin = port->ctsPin;
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+	GPIO_Init(port->ctsGpio, &GPIO_InitStructure);
+
+	// Enable hardware CTS.
+	port->usart->CR3 |= USART_CR3_CTSE;
+
+	// Drive RTS from the rx buffer occupancy.
+	CircularBuffer_setWatermarks(&uart->rxBufferObject, high, low, CircularUART_RxWatermark);
+
+	// Success.
+	return true;
 }
 
 /*
  * @brief Clear the TX buffer and fault flag.
+ * @param uart The port handle.
  */
-void CircularUART_ClearTx(void) {
-	//-- Disable the USART1 transmit buffer empty interrupt.
-	USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+void CircularUART_ClearTx(CircularUART_t * const uart) {
+	//-- Disable the USART transmit buffer empty interrupt.
+	USART_ITConfig(uart->port->usart, USART_IT_TXE, DISABLE);
+#if CIRCULARUART_TX_DMA
+	CircularUART_StopTxDma(uart);
+#endif
 
 	// Initialize the buffer.
-	CircularBuffer_checkAndClearFault(&txBufferObject, true);
+	CircularBuffer_checkAndClearFault(&uart->txBufferObject, true);
 }
 
 /*
  * @brief Clear the RX buffer and fault flag.
+ * @param uart The port handle.
  */
-void CircularUART_ClearRx(void) {
+void CircularUART_ClearRx(CircularUART_t * const uart) {
 	// Clear buffer and fault.
-	CircularBuffer_checkAndClearFault(&rxBufferObject, true);
+	CircularBuffer_checkAndClearFault(&uart->rxBufferObject, true);
+}
+
+/*
+ * @brief Starts the transmission if tx is idle.
+ * @param uart The port handle.
+ */
+static void CircularUART_TriggerTx(CircularUART_t * const uart) {
+#if CIRCULARUART_TX_DMA
+	if (uart->port->txDmaChannel) {
+		// Start DMA if idle, masking transfer-complete so the span is not chained twice.
+		NVIC_DisableIRQ(uart->port->txDmaIrq);
+		CircularUART_StartTxDma(uart);
+		NVIC_EnableIRQ(uart->port->txDmaIrq);
+		return;
+	}
+#endif
+
+	// Trigger the first transmission if TX is idle.
+	if (USART_GetFlagStatus(uart->port->usart, USART_FLAG_TC)) {
+		//-- Enable the USART receive buffer not empty interrupt.
+		USART_ITConfig(uart->port->usart, USART_IT_TXE, ENABLE);
+	}
 }
 
 /*
  * @brief Triggers transmission of data.
+ * @param uart The port handle.
  * @param data Data to send.
  * @param maxlen The requested length for sending data.
  * @return Returns the actual length that was copied to the tx buffer.
  */
-uint16_t CircularUART_Send(const uint8_t * data, const uint16_t maxlen) {
-	uint16_t result = CircularBuffer_pushBack(&txBufferObject, data, maxlen);
+uint16_t CircularUART_Send(CircularUART_t * const uart, const uint8_t * data, const uint16_t maxlen) {
+	uint16_t result = CircularBuffer_pushBack(&uart->txBufferObject, data, maxlen);
 
-	// Trigger the first transmission if TX is idle.
-	if (USART_GetFlagStatus(USART1, USART_FLAG_TC)) {
-		//-- Enable the USART1 receive buffer not empty interrupt.
-		USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+	// Start transmission.
+	CircularUART_TriggerTx(uart);
+
+	// Return result.
+	return result;
+}
+
+/*
+ * @brief Encodes a frame straight into the tx buffer and triggers transmission.
+ * @param uart The port handle.
+ * @param codec The framing.
+ * @param data The payload.
+ * @param len Size of the payload.
+ * @return Returns the size of the encoded frame, 0 if it did not fit in the tx buffer.
+ */
+uint16_t CircularUART_SendFrame(CircularUART_t * const uart, const CircularFrameCodec_t codec, const uint8_t * data, const uint16_t len) {
+	uint16_t result = CircularFrame_encode(&uart->txBufferObject, codec, data, len);
+
+	// Start transmission.
+	if (result) {
+		CircularUART_TriggerTx(uart);
 	}
 
 	// Return result.
@@ -169,49 +466,196 @@ uint16_t CircularUART_Send(const uint8_t * data, const uint16_t maxlen) {
 
 /*
  * @brief Get the received data from rx buffer.
+ * @param uart The port handle.
  * @param data Memory to write the received data.
  * @param maxlen The requested length for receiving data.
  * @return Returns the actual length that was copied from the rx buffer.
  */
-uint16_t CircularUART_Receive(uint8_t * data, const uint16_t maxlen) {
-	return CircularBuffer_popFront(&rxBufferObject, data, maxlen);
+uint16_t CircularUART_Receive(CircularUART_t * const uart, uint8_t * data, const uint16_t maxlen) {
+	return CircularBuffer_popFront(&uart->rxBufferObject, data, maxlen);
+}
+
+/*
+ * @brief Get the received data from rx buffer, sleeping until enough data arrives. Mirrors termios VMIN/VTIME:
+ *        with minlen > 0 waits for minlen bytes, timeoutTicks (if not 0) is an inter-byte timeout started by the
+ *        first byte; with minlen = 0 waits for any data, timeoutTicks (if not 0) is a total timeout.
+ * @param uart The port handle.
+ * @param data Memory to write the received data.
+ * @param minlen The minimum length to wait for, limited by maxlen, the rx buffer capacity and the high watermark.
+ * @param maxlen The requested length for receiving data.
+ * @param timeoutTicks Timeout in CIRCULARUART_GETTICK() ticks.
+ * @return Returns the actual length that was copied from the rx buffer.
+ */
+uint16_t CircularUART_ReceiveTimed(CircularUART_t * const uart, uint8_t * data, const uint16_t minlen, const uint16_t maxlen, const uint32_t timeoutTicks) {
+	// The minimum is limited by the output memory and by what the rx buffer can hold.
+	uint16_t minimum = (minlen < maxlen) ? minlen : maxlen;
+	if (minimum > uart->rxBufferObject.capacity) {
+		minimum = uart->rxBufferObject.capacity;
+	}
+
+	// With flow control the peer stops at the high watermark, so more would never arrive.
+	if (uart->rxBufferObject.watermarkCallback && (minimum > uart->rxBufferObject.highWatermark)) {
+		minimum = uart->rxBufferObject.highWatermark;
+	}
+	uint16_t seen = 0;
+	uint32_t mark = CIRCULARUART_GETTICK();
+
+	for (;;) {
+		const uint16_t unread = CircularBuffer_getUnreadSize(&uart->rxBufferObject);
+
+		// Enough data, or nothing to wait for.
+		if (minimum ? (unread >= minimum) : (unread || !timeoutTicks)) {
+			break;
+		}
+
+		// New data restarts the inter-byte timer.
+		if (unread != seen) {
+			seen = unread;
+			mark = CIRCULARUART_GETTICK();
+		}
+
+		// Timeout, total without minimum or inter-byte after the first byte.
+		if (timeoutTicks && (!minimum || seen) && ((uint32_t)(CIRCULARUART_GETTICK() - mark) >= timeoutTicks)) {
+			break;
+		}
+
+		// Sleep until the next interrupt.
+		CIRCULARUART_IDLE(&uart->rxBufferObject, unread);
+	}
+
+	// Pop what is available.
+	return CircularBuffer_popFront(&uart->rxBufferObject, data, maxlen);
 }
 
 /*
  * @brief Get the number of bytes that are still in tx buffer.
+ * @param uart The port handle.
  * @return Returns the number of unsent bytes.
  */
-uint16_t CircularUART_GetUnsentCount(void) {
-	return CircularBuffer_getUnreadSize(&txBufferObject);
+uint16_t CircularUART_GetUnsentCount(const CircularUART_t * const uart) {
+	return CircularBuffer_getUnreadSize(&uart->txBufferObject);
 }
 
 /*
  * @brief Get the number of received bytes in the rx buffer.
+ * @param uart The port handle.
  * @return Returns the number of unread bytes.
  */
-uint16_t CircularUART_GetUnreadCount(void) {
-	return CircularBuffer_getUnreadSize(&rxBufferObject);
+uint16_t CircularUART_GetUnreadCount(const CircularUART_t * const uart) {
+	return CircularBuffer_getUnreadSize(&uart->rxBufferObject);
 }
 
 /*
- * @brief Interrupt handler for RX and TX operations.
+ * @brief Interrupt handler for RX and TX operations, shared by all ports.
+ * @param uart The port handle.
  */
-void USART1_IRQHandler(void) {
+void CircularUART_IRQHandler(CircularUART_t * const uart) {
+	USART_TypeDef * const usart = uart->port->usart;
+
 	//-- Transmit buffer empty interrupt.
-	if (USART_GetITStatus(USART1, USART_IT_TXE)) {
-		// Pop from tx buffer (if available) to UART.
-		uint8_t data;
-		if (CircularBuffer_popFrontByte(&txBufferObject, &data)) {
-			USART_SendData(USART1, data);
+	if (USART_GetITStatus(usart, USART_IT_TXE)) {
+		// Fill the transmitter from the contiguous tx span while it has space, then release the sent bytes at once.
+		const uint8_t * span;
+		const uint16_t len = CircularBuffer_getFrontSpan(&uart->txBufferObject, &span);
+		uint16_t count = 0;
+		while ((count < len) && USART_GetFlagStatus(usart, USART_FLAG_TXE)) {
+			USART_SendData(usart, span[count++]);
+		}
+		if (count) {
+			CircularBuffer_advanceFront(&uart->txBufferObject, count);
 		} else {
-			//-- Disable the USART1 transmit buffer empty interrupt.
-			USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+			//-- Disable the USART transmit buffer empty interrupt.
+			USART_ITConfig(usart, USART_IT_TXE, DISABLE);
 		}
 	}
 
 	//-- Reception complete interrupt.
-	if (USART_GetITStatus(USART1, USART_IT_RXNE)) {
-		// Push from UART to rx buffer.
-		CircularBuffer_pushBackByte(&rxBufferObject, USART_ReceiveData(USART1));
+	if (USART_GetITStatus(usart, USART_IT_RXNE)) {
+		// Drain the receiver into the contiguous rx span, publishing the received bytes at once.
+		uint8_t * span = NULL;
+		uint16_t len = 0, count = 0;
+		do {
+			const uint8_t data = (uint8_t)USART_ReceiveData(usart);
+
+			// Span is exhausted, publish it and continue after the wrap.
+			if (count == len) {
+				if (count) {
+					CircularBuffer_advanceBack(&uart->rxBufferObject, count);
+				}
+				count = 0;
+				len = CircularBuffer_getBackSpan(&uart->rxBufferObject, &span);
+			}
+
+			// Store the byte, or let the push record the fault if the buffer is full.
+			if (count < len) {
+				span[count++] = data;
+			} else {
+				CircularBuffer_pushBackByte(&uart->rxBufferObject, data);
+			}
+		} while (USART_GetFlagStatus(usart, USART_FLAG_RXNE));
+		if (count) {
+			CircularBuffer_advanceBack(&uart->rxBufferObject, count);
+		}
+	}
+}
+
+#if CIRCULARUART_TX_DMA
+/*
+ * @brief Interrupt handler for TX DMA transfer-complete, shared by all ports.
+ * @param uart The port handle.
+ */
+void CircularUART_DMAIRQHandler(CircularUART_t * const uart) {
+	//-- Transfer complete interrupt.
+	if (DMA_GetITStatus(uart->port->txDmaComplete)) {
+		DMA_ClearITPendingBit(uart->port->txDmaComplete);
+
+		// Release the sent span and chain the next one (post-wrap segment or newly queued data).
+		CircularBuffer_advanceFront(&uart->txBufferObject, uart->txDmaLength);
+		uart->txDmaLength = 0;
+		CircularUART_StartTxDma(uart);
 	}
 }
+#endif
+
+#if CIRCULARUART_VECTORS
+/*
+ * @brief Dispatches a vector to the instance bound to the port, if any.
+ * @param index The port index.
+ * @param dma Set true for the tx DMA vector.
+ */
+static void CircularUART_Dispatch(const uint8_t index, const bool dma) {
+	CircularUART_t * const uart = instances[index];
+	if (!uart) {
+		return;
+	}
+#if CIRCULARUART_TX_DMA
+	if (dma) {
+		CircularUART_DMAIRQHandler(uart);
+		return;
+	}
+#endif
+	(void)dma;
+	CircularUART_IRQHandler(uart);
+}
+
+// Interrupt vectors.
+void USART1_IRQHandler(void) { CircularUART_Dispatch(0, false); }
+void USART2_IRQHandler(void) { CircularUART_Dispatch(1, false); }
+void USART3_IRQHandler(void) { CircularUART_Dispatch(2, false); }
+#if CIRCULARUART_PORT_COUNT > 3
+void UART4_IRQHandler(void) { CircularUART_Dispatch(3, false); }
+void UART5_IRQHandler(void) { CircularUART_Dispatch(4, false); }
+#endif
+#if CIRCULARUART_TX_DMA
+void DMA1_Channel4_IRQHandler(void) { CircularUART_Dispatch(0, true); }
+void DMA1_Channel7_IRQHandler(void) { CircularUART_Dispatch(1, true); }
+void DMA1_Channel2_IRQHandler(void) { CircularUART_Dispatch(2, true); }
+#if CIRCULARUART_PORT_COUNT > 3
+#if defined(STM32F10X_CL)
+void DMA2_Channel5_IRQHandler(void) { CircularUART_Dispatch(3, true); }
+#else
+void DMA2_Channel4_5_IRQHandler(void) { CircularUART_Dispatch(3, true); }
+#endif
+#endif
+#endif
+#endif
@@ -32,16 +32,44 @@
 
 // Includes.
 #include <stdio.h>
+#include "circularbuffer.h"
+#include "circularframe.h"
+
+// Type definitions.
+typedef struct CircularUARTPort_s CircularUARTPort_t;
+typedef struct{
+	CircularBufferObject_t rxBufferObject;
+	CircularBufferObject_t txBufferObject;
+	const CircularUARTPort_t * port;
+	volatile uint16_t txDmaLength;
+}CircularUART_t;
+
+// Ports.
+extern const CircularUARTPort_t CircularUART_USART1;
+extern const CircularUARTPort_t CircularUART_USART2;
+extern const CircularUARTPort_t CircularUART_USART3;
+#if defined(STM32F10X_HD) || defined(STM32F10X_XL) || defined(STM32F10X_HD_VL) || defined(STM32F10X_CL)
+extern const CircularUARTPort_t CircularUART_UART4;
+extern const CircularUARTPort_t CircularUART_UART5;
+#endif
 
 // Prototypes.
-void CircularUART_Init(const uint32_t baud, const uint8_t parity);
-void CircularUART_StartTx(uint8_t * const buffer, const uint8_t length_2N);
-void CircularUART_StartRx(uint8_t * const buffer, const uint8_t length_2N);
-void CircularUART_ClearTx(void);
-void CircularUART_ClearRx(void);
-uint16_t CircularUART_Send(const uint8_t * data, const uint16_t maxlen);
-uint16_t CircularUART_Receive(uint8_t * data, const uint16_t maxlen);
-uint16_t CircularUART_GetUnsentCount(void);
-uint16_t CircularUART_GetUnreadCount(void);
+void CircularUART_Init(CircularUART_t * const uart, const CircularUARTPort_t * const port, const uint32_t baud, const uint8_t parity);
+void CircularUART_StartTx(CircularUART_t * const uart, uint8_t * const buffer, const uint8_t length_2N);
+void CircularUART_StartRx(CircularUART_t * const uart, uint8_t * const buffer, const uint8_t length_2N);
+bool CircularUART_EnableFlowControl(CircularUART_t * const uart, const uint16_t high, const uint16_t low);
+void CircularUART_ClearTx(CircularUART_t * const uart);
+void CircularUART_ClearRx(CircularUART_t * const uart);
+uint16_t CircularUART_Send(CircularUART_t * const uart, const uint8_t * data, const uint16_t maxlen);
+uint16_t CircularUART_SendFrame(CircularUART_t * const uart, const CircularFrameCodec_t codec, const uint8_t * data, const uint16_t len);
+uint16_t CircularUART_Receive(CircularUART_t * const uart, uint8_t * data, const uint16_t maxlen);
+uint16_t CircularUART_ReceiveTimed(CircularUART_t * const uart, uint8_t * data, const uint16_t minlen, const uint16_t maxlen, const uint32_t timeoutTicks);
+uint16_t CircularUART_GetUnsentCount(const CircularUART_t * const uart);
+uint16_t CircularUART_GetUnreadCount(const CircularUART_t * const uart);
+void CircularUART_IRQHandler(CircularUART_t * const uart);
+void CircularUART_DMAIRQHandler(CircularUART_t * const uart);
+
+// Tick source for CircularUART_ReceiveTimed, provided by the application, i.e. counted in SysTick_Handler.
+uint32_t CircularUART_GetTick(void);
 
 #endif